@@ -0,0 +1,32 @@
+#version 430 core
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+// Pairs of Gaussian taps are merged into one bilinear fetch, so MAX_TAPS covers a radius of 2 * (MAX_TAPS - 1).
+#define MAX_TAPS 33
+
+uniform sampler2D Source;
+uniform vec2 UvScale = vec2(1.0);
+uniform vec2 UvMax = vec2(1.0);
+// One texel along the blur axis in texture coordinates.
+uniform vec2 Direction;
+uniform int TapCount;
+uniform float Weights[MAX_TAPS];
+uniform float Offsets[MAX_TAPS];
+
+void main()
+{
+    vec2 uv = min(texCoords * UvScale, UvMax);
+    vec3 color = texture(Source, uv).rgb * Weights[0];
+
+    for (int i = 1; i < TapCount; ++i)
+    {
+        vec2 offset = Direction * Offsets[i];
+        color += texture(Source, min(uv + offset, UvMax)).rgb * Weights[i];
+        color += texture(Source, max(uv - offset, vec2(0.0))).rgb * Weights[i];
+    }
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,18 @@
+#version 430 core
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform sampler2D Source;
+uniform vec2 UvScale = vec2(1.0);
+uniform vec2 UvMax = vec2(1.0);
+// Applied as ColorMatrix * color + ColorOffset.
+uniform mat3 ColorMatrix;
+uniform vec3 ColorOffset;
+
+void main()
+{
+    vec2 uv = min(texCoords * UvScale, UvMax);
+    FragColor = vec4(ColorMatrix * texture(Source, uv).rgb + ColorOffset, 1.0);
+}
@@ -0,0 +1,53 @@
+#version 430 core
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_SPAN_MAX 8.0
+
+uniform sampler2D Source;
+uniform vec2 UvScale = vec2(1.0);
+uniform vec2 UvMax = vec2(1.0);
+
+float luma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+vec3 fetch(vec2 uv)
+{
+    return texture(Source, clamp(uv, vec2(0.0), UvMax)).rgb;
+}
+
+void main()
+{
+    vec2 uv = min(texCoords * UvScale, UvMax);
+    vec2 texel = 1.0 / vec2(textureSize(Source, 0));
+
+    // Luma of the pixel and its diagonal neighbours.
+    vec3 colorM = fetch(uv);
+    float lumaM = luma(colorM);
+    float lumaNW = luma(fetch(uv + vec2(-1.0, 1.0) * texel));
+    float lumaNE = luma(fetch(uv + vec2(1.0, 1.0) * texel));
+    float lumaSW = luma(fetch(uv + vec2(-1.0, -1.0) * texel));
+    float lumaSE = luma(fetch(uv + vec2(1.0, -1.0) * texel));
+
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // Blur along the edge, perpendicular to the luma gradient.
+    vec2 direction = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float directionReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float inverseDirectionMin = 1.0 / (min(abs(direction.x), abs(direction.y)) + directionReduce);
+    direction = clamp(direction * inverseDirectionMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * texel;
+
+    vec3 colorA = 0.5 * (fetch(uv + direction * (1.0 / 3.0 - 0.5)) + fetch(uv + direction * (2.0 / 3.0 - 0.5)));
+    vec3 colorB = colorA * 0.5 + 0.25 * (fetch(uv - direction * 0.5) + fetch(uv + direction * 0.5));
+
+    // Fall back to the narrower sample if the wide one stepped over another edge.
+    float lumaB = luma(colorB);
+    FragColor = vec4((lumaB < lumaMin || lumaB > lumaMax) ? colorA : colorB, 1.0);
+}
@@ -0,0 +1,10 @@
+#version 430 core
+
+out vec4 fragColor;
+
+uniform vec4 Color;
+
+void main()
+{
+    fragColor = Color;
+}
@@ -0,0 +1,18 @@
+#version 430 core
+
+// One frame time per vertex; its position along the graph is its index.
+layout (location = 0) in float frameTime;
+
+uniform mat4 Projection;
+// Bottom-left corner and size of the graph in pixels.
+uniform vec2 Origin;
+uniform vec2 Size;
+uniform float MaxMilliseconds;
+uniform int Count;
+
+void main()
+{
+    float x = Origin.x + Size.x * float(gl_VertexID) / max(float(Count - 1), 1.0);
+    float y = Origin.y - Size.y * clamp(frameTime / MaxMilliseconds, 0.0, 1.0);
+    gl_Position = Projection * vec4(x, y, 0.0, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 430 core
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform sampler2D Source;
+uniform vec2 UvScale = vec2(1.0);
+uniform vec2 UvMax = vec2(1.0);
+// 3x3 convolution kernel, row by row from the top-left.
+uniform float Kernel[9];
+
+void main()
+{
+    vec2 uv = min(texCoords * UvScale, UvMax);
+    vec2 texel = 1.0 / vec2(textureSize(Source, 0));
+
+    vec3 color = vec3(0.0);
+    for (int i = 0; i < 9; ++i)
+    {
+        vec2 offset = vec2(float(i % 3 - 1), float(1 - i / 3)) * texel;
+        color += texture(Source, clamp(uv + offset, vec2(0.0), UvMax)).rgb * Kernel[i];
+    }
+
+    FragColor = vec4(color, 1.0);
+}
@@ -1,15 +1,25 @@
 #version 430 core
 
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec2 Velocity;
 
 in vec2 texCoords;
+in vec4 currentPosition;
+in vec4 previousPosition;
 
 uniform struct MATERIAL
 {
     sampler2D diffuse;
 } Material;
 
+// Screen-space motion since the last frame in texture coordinates. Only stored when the target has a velocity buffer.
+vec2 velocity()
+{
+    return (currentPosition.xy / currentPosition.w - previousPosition.xy / previousPosition.w) * 0.5;
+}
+
 void main()
 {
     FragColor = texture(Material.diffuse, texCoords);
+    Velocity = velocity();
 }
@@ -1,8 +1,11 @@
 #version 430 core
 
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec2 Velocity;
 
 in vec2 texCoords;
+in vec4 currentPosition;
+in vec4 previousPosition;
 in vec3 normal;
 in vec3 fragPos;
 
@@ -34,6 +37,8 @@ uniform struct sPointLight
     vec3 diffuse;
     vec3 specular;
 } PointLight[NUM_POINT_LIGHTS];
+// Lights in use, at most NUM_POINT_LIGHTS.
+uniform int PointLightCount;
 
 uniform struct sSpotLight
 {
@@ -49,6 +54,11 @@ uniform struct sSpotLight
     vec3 specular;
 } SpotLight;
 
+// Screen-space motion since the last frame in texture coordinates. Only stored when the target has a velocity buffer.
+vec2 velocity()
+{
+    return (currentPosition.xy / currentPosition.w - previousPosition.xy / previousPosition.w) * 0.5;
+}
 vec3 calcDirLight(sDirLight light, vec3 normal, vec3 viewDir);
 vec3 calcPointLight(sPointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 vec3 calcSpotLight(sSpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
@@ -62,7 +72,7 @@ void main()
     vec3 result = calcDirLight(DirLight, norm, viewDir);
 
     // Point lights
-    for (int i = 0; i < NUM_POINT_LIGHTS; ++i)
+    for (int i = 0; i < min(PointLightCount, NUM_POINT_LIGHTS); ++i)
     {
         result += calcPointLight(PointLight[i], norm, fragPos, viewDir);
     }
@@ -71,6 +81,7 @@ void main()
     result += calcSpotLight(SpotLight, norm, fragPos, viewDir);
 
     FragColor = vec4(result, 1.0);
+    Velocity = velocity();
 }
 
 vec3 calcDirLight(sDirLight light, vec3 normal, vec3 viewDir)
@@ -9,10 +9,16 @@ layout (location = 4) in vec3 aBittangent;
 out vec2 texCoords;
 out vec3 normal;
 out vec3 fragPos;
+out vec4 currentPosition;
+out vec4 previousPosition;
 
 uniform mat4 Model;
 uniform mat4 ViewProjection;
 uniform mat3 Normal;
+// Used for motion vectors: this frame's view-projection without jitter, and last frame's matrices.
+uniform mat4 UnjitteredViewProjection;
+uniform mat4 PrevModel;
+uniform mat4 PrevViewProjection;
 
 void main()
 {
@@ -20,4 +26,6 @@ void main()
     normal = Normal * aNormal;
     fragPos = vec3(Model * vec4(aPos, 1.0));
     texCoords = aTexCoords;
+    currentPosition = UnjitteredViewProjection * Model * vec4(aPos, 1.0);
+    previousPosition = PrevViewProjection * PrevModel * vec4(aPos, 1.0);
 }
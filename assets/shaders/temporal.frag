@@ -0,0 +1,59 @@
+#version 430 core
+
+// Reconstructs the output from a jittered scene rendered at a lower resolution and the reprojected output of the
+// previous frame. The history is clamped to the colors around the current sample so stale colors do not ghost.
+
+out vec4 FragColor;
+
+in vec2 texCoords;
+
+uniform sampler2D Scene;
+uniform sampler2D Velocity;
+uniform sampler2D History;
+// Size of the region of the scene target that was rendered to, in texels.
+uniform vec2 RenderSize;
+// Projection jitter of the current frame in scene texels.
+uniform vec2 Jitter;
+// Portion of the history target covered by the output, and the last texel centre to sample from.
+uniform vec2 HistoryUvScale;
+uniform vec2 HistoryUvMax;
+// Weight of the history for a sample that lands exactly on the output pixel. Zero discards the history.
+uniform float HistoryWeight;
+
+void main()
+{
+    // Position of this output pixel in the jittered scene, and the scene texel closest to it.
+    vec2 scenePosition = texCoords * RenderSize + Jitter;
+    ivec2 maxTexel = ivec2(RenderSize) - 1;
+    ivec2 texel = clamp(ivec2(scenePosition), ivec2(0), maxTexel);
+
+    vec3 current = texelFetch(Scene, texel, 0).rgb;
+    vec3 neighbourhoodMin = current;
+    vec3 neighbourhoodMax = current;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            vec3 neighbour = texelFetch(Scene, clamp(texel + ivec2(x, y), ivec2(0), maxTexel), 0).rgb;
+            neighbourhoodMin = min(neighbourhoodMin, neighbour);
+            neighbourhoodMax = max(neighbourhoodMax, neighbour);
+        }
+    }
+
+    vec2 historyUv = texCoords - texelFetch(Velocity, texel, 0).rg;
+    if (HistoryWeight <= 0.0 || any(lessThan(historyUv, vec2(0.0))) || any(greaterThan(historyUv, vec2(1.0))))
+    {
+        FragColor = vec4(current, 1.0);
+        return;
+    }
+
+    vec3 history = texture(History, min(historyUv * HistoryUvScale, HistoryUvMax)).rgb;
+    history = clamp(history, neighbourhoodMin, neighbourhoodMax);
+
+    // The further the sample is from the centre of this output pixel, the less it contributes.
+    vec2 offset = fract(scenePosition) - 0.5;
+    float confidence = exp(-2.0 * dot(offset, offset));
+    float blend = max((1.0 - HistoryWeight) * confidence, 0.02);
+
+    FragColor = vec4(mix(history, current, blend), 1.0);
+}
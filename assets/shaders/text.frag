@@ -1,14 +1,18 @@
 #version 430 core
 
-in vec2 texCoords;
+in vec3 texCoords;
+in vec4 textColor;
 
 out vec4 fragColor;
 
-uniform sampler2D Text;
-uniform vec4 TextColor;
+uniform sampler2DArray Text;
 
 void main()
 {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(Text, texCoords).r);
-    fragColor = TextColor * sampled;
+    // The atlas stores distance fields with the outline at 0.5; smooth the edge over about one screen pixel so text
+    // stays sharp at any scale.
+    float distance = texture(Text, texCoords).r;
+    float width = max(fwidth(distance), 1e-4);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    fragColor = vec4(textColor.rgb, textColor.a * alpha);
 }
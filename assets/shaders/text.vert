@@ -1,13 +1,20 @@
 #version 430 core
 
 layout (location = 0) in vec4 vertex;
+// Per string: its color and the position it is drawn at.
+layout (location = 1) in vec4 color;
+layout (location = 2) in vec2 offset;
+// Atlas page the glyph is stored in.
+layout (location = 3) in float page;
 
-out vec2 texCoords;
+out vec3 texCoords;
+out vec4 textColor;
 
 uniform mat4 Projection;
 
 void main()
 {
-    gl_Position = Projection * vec4(vertex.xy, 0.0, 1.0);
-    texCoords = vertex.zw;
+    gl_Position = Projection * vec4(vertex.xy + offset, 0.0, 1.0);
+    texCoords = vec3(vertex.zw, page);
+    textColor = color;
 }
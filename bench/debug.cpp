@@ -0,0 +1,34 @@
+#include "../src/debug/flightRecorder.hpp"
+#include "../src/debug/profiler.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    // What the flight recorder adds to a frame: timing every scope, handing the scopes over and recording the frame.
+    // The game's frames have a few dozen scopes.
+    void flightRecorderFrame(benchmark::State& state)
+    {
+        static bool enabled = false;
+        if (!enabled)
+        {
+            FlightRecorder::enable(10.0f, 1000.0f);
+            enabled = true;
+        }
+
+        GlCounters::Counts counts;
+        for (auto _ : state)
+        {
+            {
+                PROFILE_SCOPE("frame");
+                for (int i = 0; i < 40; ++i)
+                {
+                    PROFILE_SCOPE("scope");
+                }
+            }
+            Profiler::endFrame();
+            FlightRecorder::endFrame(16.0f, 12.0f, counts);
+        }
+    }
+}
+
+BENCHMARK(flightRecorderFrame);
@@ -0,0 +1,114 @@
+#include "../src/input/inputQueue.hpp"
+#include "../src/input/keyboard.hpp"
+#include <benchmark/benchmark.h>
+
+namespace
+{
+    int calls = 0;
+
+    // Roughly the bindings the game registers: a handful of keys with one or two callbacks each.
+    void addBindings()
+    {
+        static bool added = false;
+        if (added)
+        {
+            return;
+        }
+        added = true;
+
+        const int keys[] = { GLFW_KEY_GRAVE_ACCENT, GLFW_KEY_F3, GLFW_KEY_F4, GLFW_KEY_ESCAPE, GLFW_KEY_ENTER,
+                             GLFW_KEY_BACKSPACE, GLFW_KEY_DELETE, GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_TAB };
+        for (int key : keys)
+        {
+            Keyboard::addKeyBinding([]() { calls++; }, key, GLFW_PRESS);
+            Keyboard::addKeyBinding([]() { calls++; }, key, GLFW_REPEAT);
+        }
+        Keyboard::addKeyBinding([]() { calls++; }, GLFW_KEY_F3, GLFW_RELEASE);
+    }
+
+    void keyEventBound(benchmark::State& state)
+    {
+        addBindings();
+        for (auto _ : state)
+        {
+            Keyboard::onKeyEvent(GLFW_KEY_F3, GLFW_PRESS, 0);
+        }
+        benchmark::DoNotOptimize(calls);
+    }
+
+    // Most key events, e.g. movement keys, have no binding.
+    void keyEventUnbound(benchmark::State& state)
+    {
+        addBindings();
+        for (auto _ : state)
+        {
+            Keyboard::onKeyEvent(GLFW_KEY_W, GLFW_PRESS, 0);
+        }
+        benchmark::DoNotOptimize(calls);
+    }
+
+    void charEvent(benchmark::State& state)
+    {
+        static bool added = false;
+        if (!added)
+        {
+            Keyboard::addCharCallback([](unsigned int codePoint) { calls += codePoint <= 0x007F; });
+            added = true;
+        }
+        for (auto _ : state)
+        {
+            Keyboard::onCharEvent('w');
+        }
+        benchmark::DoNotOptimize(calls);
+    }
+
+    // A frame of movement: a few key events and the per-frame state update.
+    void updateKeyStates(benchmark::State& state)
+    {
+        addBindings();
+        int frame = 0;
+        for (auto _ : state)
+        {
+            Keyboard::onKeyEvent(frame % 2 == 0 ? GLFW_KEY_W : GLFW_KEY_A, GLFW_PRESS, 0);
+            Keyboard::onKeyEvent(frame % 2 == 0 ? GLFW_KEY_A : GLFW_KEY_W, GLFW_RELEASE, 0);
+            Keyboard::update();
+            frame++;
+        }
+        benchmark::DoNotOptimize(Keyboard::pressed(GLFW_KEY_W));
+    }
+
+    // No input at all, the common case.
+    void updateIdle(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            Keyboard::update();
+        }
+        benchmark::DoNotOptimize(Keyboard::once(GLFW_KEY_W));
+    }
+
+    // A frame of a 1000 Hz mouse at 60 Hz: what the callbacks push and the game pops.
+    void queueCursorEvents(benchmark::State& state)
+    {
+        static InputQueue queue;
+        InputEvent event;
+        for (auto _ : state)
+        {
+            for (int i = 0; i < 16; ++i)
+            {
+                queue.pushCursorPos(i, i);
+            }
+            while (queue.pop(event))
+            {
+                benchmark::DoNotOptimize(event);
+            }
+        }
+    }
+}
+
+BENCHMARK(keyEventBound);
+BENCHMARK(keyEventUnbound);
+BENCHMARK(charEvent);
+BENCHMARK(updateKeyStates);
+BENCHMARK(updateIdle);
+BENCHMARK(queueCursorEvents);
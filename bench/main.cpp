@@ -0,0 +1,27 @@
+#include "stubGl.hpp"
+#include "../src/debug/log.hpp"
+#include <benchmark/benchmark.h>
+#include <spdlog/sinks/null_sink.h>
+#include <spdlog/spdlog.h>
+#include <cstdio>
+#include <memory>
+
+int main(int argc, char** argv)
+{
+    // The engine's log output would only disturb the timings.
+    setLogger(std::make_shared<spdlog::logger>("logger", std::make_shared<spdlog::sinks::null_sink_mt>()));
+
+    if (auto result = loadStubGl())
+    {
+        std::fprintf(stderr, "%s\n", result.value().c_str());
+        return 1;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "../src/camera.hpp"
+#include "../src/util/frustum.hpp"
+#include <benchmark/benchmark.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    // The cubes of the default scene.
+    const glm::vec3 POSITIONS[] = {
+        glm::vec3( 0.0f,  0.0f,  0.0f),
+        glm::vec3( 2.0f,  5.0f, -15.0f),
+        glm::vec3(-1.5f, -2.2f, -2.5f),
+        glm::vec3(-3.8f, -2.0f, -12.3f),
+        glm::vec3( 2.4f, -0.4f, -3.5f),
+        glm::vec3(-1.7f,  3.0f, -7.5f),
+        glm::vec3( 1.3f, -2.0f, -2.5f),
+        glm::vec3( 1.5f,  2.0f, -2.5f),
+        glm::vec3( 1.5f,  0.2f, -1.5f),
+        glm::vec3(-1.3f,  1.0f, -1.5f)
+    };
+
+    void cameraViewFrustum(benchmark::State& state)
+    {
+        Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(camera.fov), 16.0f / 9.0f, 0.1f, 100.0f);
+        float yaw = -90.0f;
+        for (auto _ : state)
+        {
+            camera.setOrientation(yaw, 0.0f);
+            Frustum frustum = extractFrustum(projection * camera.getViewMatrix());
+            int visible = 0;
+            for (const glm::vec3& position : POSITIONS)
+            {
+                visible += intersects(frustum, position - 0.5f, position + 0.5f);
+            }
+            benchmark::DoNotOptimize(visible);
+            yaw += 0.1f;
+        }
+    }
+
+    // The model and normal matrices drawScene() computes for every object.
+    void objectMatrices(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i < std::size(POSITIONS); ++i)
+            {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), POSITIONS[i]);
+                model = glm::rotate(model, glm::radians(20.0f * static_cast<float>(i)), glm::vec3(1.0f, 0.3f, 0.5f));
+                glm::mat3 normal = glm::mat3(glm::transpose(glm::inverse(model)));
+                benchmark::DoNotOptimize(model);
+                benchmark::DoNotOptimize(normal);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(std::size(POSITIONS)));
+    }
+}
+
+BENCHMARK(cameraViewFrustum);
+BENCHMARK(objectMatrices);
@@ -0,0 +1,124 @@
+#include "../src/renderer/model.hpp"
+#include "../src/renderer/shader.hpp"
+#include "../src/renderer/textRenderer.hpp"
+#include "../src/renderer/texture.hpp"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+struct ModelBenchmarkAccess
+{
+    static Mesh processMesh(Model& model, aiMesh* mesh, const aiScene* scene)
+    {
+        return model.processMesh(mesh, scene);
+    }
+};
+
+namespace
+{
+    const char* MODEL_PATH = "assets/models/nanosuit/nanosuit.obj";
+
+    bool hasAssets(benchmark::State& state)
+    {
+        if (!std::filesystem::exists("assets"))
+        {
+            state.SkipWithError("Run from the directory containing the assets.");
+            return false;
+        }
+        return true;
+    }
+
+    // Conversion of assimp's meshes into vertices and indices. Textures are already cached by the model.
+    void modelProcessMesh(benchmark::State& state)
+    {
+        if (!hasAssets(state))
+        {
+            return;
+        }
+
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(MODEL_PATH, aiProcess_Triangulate | aiProcess_FlipUVs);
+        Model model(MODEL_PATH);
+        int64_t vertices = 0;
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+        {
+            vertices += scene->mMeshes[i]->mNumVertices;
+        }
+
+        for (auto _ : state)
+        {
+            for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+            {
+                Mesh mesh = ModelBenchmarkAccess::processMesh(model, scene->mMeshes[i], scene);
+                benchmark::DoNotOptimize(mesh.vertices.data());
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * vertices);
+    }
+
+    void textureDecode(benchmark::State& state, const std::string& file, const std::string& directory)
+    {
+        if (!hasAssets(state))
+        {
+            return;
+        }
+
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(textureFromFile(file, directory));
+        }
+        state.SetBytesProcessed(state.iterations() *
+                                static_cast<int64_t>(std::filesystem::file_size(directory + "/" + file)));
+    }
+
+    std::unique_ptr<TextRenderer> createTextRenderer()
+    {
+        auto shader = std::make_shared<Shader>("assets/shaders/text.vert", "assets/shaders/text.frag");
+        return std::make_unique<TextRenderer>(1920, 1080, shader, "assets/fonts/OCRAEXT.TTF", 14);
+    }
+
+    // Text that changes every frame, like the frame time in the stats overlay, is laid out again each time.
+    void textLayout(benchmark::State& state)
+    {
+        if (!hasAssets(state))
+        {
+            return;
+        }
+
+        std::unique_ptr<TextRenderer> textRenderer = createTextRenderer();
+        int frame = 0;
+        for (auto _ : state)
+        {
+            textRenderer->render(fmt::format("Frame p50 {:.2f} p95 {:.2f} p99 {:.2f}ms", frame * 0.01, frame * 0.02,
+                                             frame * 0.03), glm::vec2(20.0f), 1.0f);
+            textRenderer->flush();
+            frame++;
+        }
+    }
+
+    // Unchanged text is drawn from its cached layout.
+    void textCached(benchmark::State& state)
+    {
+        if (!hasAssets(state))
+        {
+            return;
+        }
+
+        std::unique_ptr<TextRenderer> textRenderer = createTextRenderer();
+        for (auto _ : state)
+        {
+            textRenderer->render("Window: 1920x1080", glm::vec2(20.0f), 1.0f);
+            textRenderer->flush();
+        }
+    }
+}
+
+BENCHMARK(modelProcessMesh)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(textureDecode, small, "white.png", "assets/textures")->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(textureDecode, large, "body_dif.png", "assets/models/nanosuit")->Unit(benchmark::kMillisecond);
+BENCHMARK(textLayout);
+BENCHMARK(textCached);
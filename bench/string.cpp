@@ -0,0 +1,28 @@
+#include "../src/util/string.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace
+{
+    // A typical console command.
+    void splitCommand(benchmark::State& state)
+    {
+        const std::string command = "set postprocess blur true";
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(split(command));
+        }
+    }
+
+    void trimPadded(benchmark::State& state)
+    {
+        const std::string padded = "   set fov 90   ";
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(trimCopy(padded));
+        }
+    }
+}
+
+BENCHMARK(splitCommand);
+BENCHMARK(trimPadded);
@@ -0,0 +1,204 @@
+#include "stubGl.hpp"
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    GLuint nextName = 1;
+
+    // Does nothing and returns zero, with exactly the signature of the glad function pointer type it is made for.
+    template <typename Function>
+    struct NoOp;
+
+    template <typename Result, typename... Arguments>
+    struct NoOp<Result (APIENTRYP)(Arguments...)>
+    {
+        static Result APIENTRY call(Arguments...)
+        {
+            return Result();
+        }
+    };
+
+    const GLubyte* APIENTRY stubGetString(GLenum name)
+    {
+        return reinterpret_cast<const GLubyte*>(name == GL_VERSION ? "4.3.0 stub" : "stub");
+    }
+
+    const GLubyte* APIENTRY stubGetStringi(GLenum, GLuint)
+    {
+        return reinterpret_cast<const GLubyte*>("");
+    }
+
+    void APIENTRY stubGetIntegerv(GLenum name, GLint* data)
+    {
+        switch (name)
+        {
+            case GL_MAJOR_VERSION:
+                *data = 4;
+                break;
+            case GL_MINOR_VERSION:
+                *data = 3;
+                break;
+            case GL_POLYGON_MODE:
+                data[0] = GL_FILL;
+                data[1] = GL_FILL;
+                break;
+            default:
+                *data = 0;
+                break;
+        }
+    }
+
+    void APIENTRY stubGenNames(GLsizei count, GLuint* names)
+    {
+        for (GLsizei i = 0; i < count; ++i)
+        {
+            names[i] = nextName++;
+        }
+    }
+
+    GLuint APIENTRY stubCreateShader(GLenum)
+    {
+        return nextName++;
+    }
+
+    GLuint APIENTRY stubCreateProgram()
+    {
+        return nextName++;
+    }
+
+    // Reports compile and link status as successful and every other parameter as zero.
+    void APIENTRY stubGetObjectiv(GLuint, GLenum name, GLint* params)
+    {
+        *params = name == GL_COMPILE_STATUS || name == GL_LINK_STATUS ? GL_TRUE : 0;
+    }
+
+    void APIENTRY stubGetInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        if (length)
+        {
+            *length = 0;
+        }
+        if (bufSize > 0)
+        {
+            infoLog[0] = '\0';
+        }
+    }
+
+    // The casts to the glad pointer types check each stub's signature at compile time.
+#define STUB(name, function) { #name, reinterpret_cast<void*>(static_cast<decltype(glad_##name)>(function)) }
+#define NO_OP(name) { #name, reinterpret_cast<void*>(&NoOp<decltype(glad_##name)>::call) }
+
+    // The functions glad's loader, the model, texture, shader and text renderer benchmarks reach.
+    const std::pair<const char*, void*> STUBS[] = {
+        STUB(glGetString, stubGetString),
+        STUB(glGetStringi, stubGetStringi),
+        STUB(glGetIntegerv, stubGetIntegerv),
+        STUB(glGenBuffers, stubGenNames),
+        STUB(glGenVertexArrays, stubGenNames),
+        STUB(glGenTextures, stubGenNames),
+        STUB(glCreateShader, stubCreateShader),
+        STUB(glCreateProgram, stubCreateProgram),
+        STUB(glGetShaderiv, stubGetObjectiv),
+        STUB(glGetProgramiv, stubGetObjectiv),
+        STUB(glGetShaderInfoLog, stubGetInfoLog),
+        STUB(glGetProgramInfoLog, stubGetInfoLog),
+        NO_OP(glActiveTexture),
+        NO_OP(glAttachShader),
+        NO_OP(glBindBuffer),
+        NO_OP(glBindTexture),
+        NO_OP(glBindVertexArray),
+        NO_OP(glBlendFunc),
+        NO_OP(glBufferData),
+        NO_OP(glBufferSubData),
+        NO_OP(glCompileShader),
+        NO_OP(glDeleteBuffers),
+        NO_OP(glDeleteShader),
+        NO_OP(glDeleteTextures),
+        NO_OP(glDeleteVertexArrays),
+        NO_OP(glDisable),
+        NO_OP(glDrawElements),
+        NO_OP(glEnable),
+        NO_OP(glEnableVertexAttribArray),
+        NO_OP(glGenerateMipmap),
+        NO_OP(glGetUniformLocation),
+        NO_OP(glLinkProgram),
+        NO_OP(glMultiDrawArraysIndirect),
+        NO_OP(glPixelStorei),
+        NO_OP(glPolygonMode),
+        NO_OP(glShaderSource),
+        NO_OP(glTexImage2D),
+        NO_OP(glTexParameteri),
+        NO_OP(glTexStorage3D),
+        NO_OP(glTexSubImage3D),
+        NO_OP(glUniform1f),
+        NO_OP(glUniform1fv),
+        NO_OP(glUniform1i),
+        NO_OP(glUniform2f),
+        NO_OP(glUniform2fv),
+        NO_OP(glUniform3f),
+        NO_OP(glUniform4f),
+        NO_OP(glUniformMatrix3fv),
+        NO_OP(glUniformMatrix4fv),
+        NO_OP(glUseProgram),
+        NO_OP(glVertexAttribDivisor),
+        NO_OP(glVertexAttribPointer)
+    };
+
+#undef NO_OP
+#undef STUB
+
+    // Enough for every function of GL 4.3 core.
+    constexpr size_t MAX_UNSTUBBED = 1024;
+    const char* unstubbedNames[MAX_UNSTUBBED];
+    size_t unstubbedCount = 0;
+
+    // Stands in for a function without a stub. It is loaded under that function's pointer type but only ever called
+    // by a benchmark reaching engine code that needs another stub, so it stops the run there and names the function.
+    template <size_t Index>
+    [[noreturn]] void APIENTRY unstubbed()
+    {
+        std::fprintf(stderr, "%s has no stub GL function, add one to bench/stubGl.cpp.\n", unstubbedNames[Index]);
+        std::abort();
+    }
+
+    template <size_t... Indices>
+    constexpr auto makeUnstubbed(std::index_sequence<Indices...>)
+    {
+        return std::array<void (APIENTRYP)(), sizeof...(Indices)> { unstubbed<Indices>... };
+    }
+
+    const auto UNSTUBBED = makeUnstubbed(std::make_index_sequence<MAX_UNSTUBBED>());
+
+    void* getStubProcAddress(const char* name)
+    {
+        for (const auto& [stubName, stub] : STUBS)
+        {
+            if (std::strcmp(name, stubName) == 0)
+            {
+                return stub;
+            }
+        }
+
+        if (unstubbedCount == MAX_UNSTUBBED)
+        {
+            return nullptr;
+        }
+        unstubbedNames[unstubbedCount] = name;
+        return reinterpret_cast<void*>(UNSTUBBED[unstubbedCount++]);
+    }
+}
+
+std::optional<std::string> loadStubGl()
+{
+    if (!gladLoadGLLoader(getStubProcAddress))
+    {
+        return "Failed to load the stub GL functions.";
+    }
+    return {};
+}
@@ -0,0 +1,16 @@
+#ifndef KUMIGAME_BENCH_STUB_GL_HPP
+#define KUMIGAME_BENCH_STUB_GL_HPP
+
+#include <optional>
+#include <string>
+
+/**
+ * @brief Loads glad with stub GL functions, so engine code runs without a display or GPU.
+ *
+ * Only the functions the benchmarks reach are stubbed, each with its own signature. Object creation hands out
+ * increasing names, shader and program queries report success and the rest do nothing and return zero. Any other
+ * function aborts with its name when called.
+ */
+std::optional<std::string> loadStubGl();
+
+#endif //KUMIGAME_BENCH_STUB_GL_HPP
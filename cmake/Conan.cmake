@@ -13,5 +13,12 @@ macro(run_conan)
   conan_add_remote(NAME bincrafters URL
       https://api.bintray.com/conan/bincrafters/public-conan)
 
-  conan_cmake_run(CONANFILE conanfile.txt BASIC_SETUP CMAKE_TARGETS BUILD missing BUILD_TYPE "Release")
+  if(KUMIGAME_BUILD_BENCHMARKS)
+    set(KUMIGAME_CONAN_OPTIONS benchmarks=True)
+  else()
+    set(KUMIGAME_CONAN_OPTIONS benchmarks=False)
+  endif()
+
+  conan_cmake_run(CONANFILE conanfile.py BASIC_SETUP CMAKE_TARGETS BUILD missing BUILD_TYPE "Release"
+      OPTIONS ${KUMIGAME_CONAN_OPTIONS})
 endmacro()
@@ -0,0 +1,34 @@
+from conans import ConanFile
+
+
+class KumigameConan(ConanFile):
+    settings = "os", "compiler", "build_type", "arch"
+    generators = "cmake"
+    requires = (
+        "assimp/5.0.1",
+        "fmt/6.1.2",
+        "freetype/2.10.1",
+        "glad/0.1.33",
+        "glfw/3.3.2@bincrafters/stable",
+        "glm/0.9.9.7",
+        "spdlog/1.5.0",
+        "stb/20200203",
+        "toml11/3.1.0",
+    )
+    # Google Benchmark is only needed by kumigame-bench, see KUMIGAME_BUILD_BENCHMARKS.
+    options = {"benchmarks": [True, False]}
+    default_options = {
+        "benchmarks": False,
+        "assimp:shared": True,
+        "glad:gl_profile": "core",
+        "glad:gl_version": "4.3",
+        "glad:spec": "gl",
+        "glad:no_loader": False,
+    }
+
+    def requirements(self):
+        if self.options.benchmarks:
+            self.requires("benchmark/1.5.0")
+
+    def imports(self):
+        self.copy("*.dll", src="bin", dst="bin")
@@ -94,6 +94,13 @@ void Camera::processMouseScroll(float yOffset)
     }
 }
 
+void Camera::setOrientation(float yaw, float pitch)
+{
+    this->yaw = yaw;
+    this->pitch = pitch;
+    updateCameraVectors();
+}
+
 void Camera::updateCameraVectors()
 {
     front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
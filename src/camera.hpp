@@ -50,6 +50,7 @@ public:
     void processKeyboard(CameraDirection direction, float deltaTime);
     void processMouseMovement(double xPos, double yPos, bool constrainPitch = true);
     void processMouseScroll(float yOffset);
+    void setOrientation(float yaw, float pitch);
 
 private:
     void updateCameraVectors();
@@ -0,0 +1,385 @@
+#include "benchmark.hpp"
+#include "../util/string.hpp"
+#include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace
+{
+    const char* USAGE = "Usage: kumigame --benchmark <scene> [--frames N] [--warmup N] [--path file] [--output file] "
+                        "[--resolution WxH] [--max-cpu-p95 ms] [--max-cpu-p99 ms] [--max-gpu-p95 ms] [--max-gpu-p99 ms]";
+
+    const std::pair<const char*, uint64_t GlCounters::Counts::*> COUNTERS[] = {
+        { "drawCalls", &GlCounters::Counts::drawCalls },
+        { "dispatches", &GlCounters::Counts::dispatches },
+        { "primitives", &GlCounters::Counts::primitives },
+        { "programBinds", &GlCounters::Counts::programBinds },
+        { "vertexArrayBinds", &GlCounters::Counts::vertexArrayBinds },
+        { "textureBinds", &GlCounters::Counts::textureBinds },
+        { "uniformUploads", &GlCounters::Counts::uniformUploads },
+        { "bufferBytes", &GlCounters::Counts::bufferBytes },
+        { "textureBytes", &GlCounters::Counts::textureBytes }
+    };
+
+    struct Statistics
+    {
+        double mean = 0.0;
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+        float p999 = 0.0f;
+        float max = 0.0f;
+    };
+
+    // Exact nearest-rank percentiles; the run is short enough to sort every frame.
+    Statistics computeStatistics(std::vector<float> values)
+    {
+        Statistics statistics;
+        if (values.empty())
+        {
+            return statistics;
+        }
+
+        std::sort(values.begin(), values.end());
+        auto percentile = [&values](double p) {
+            auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(values.size())));
+            return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+        };
+
+        for (float value : values)
+        {
+            statistics.mean += value;
+        }
+        statistics.mean /= static_cast<double>(values.size());
+        statistics.p50 = percentile(0.5);
+        statistics.p95 = percentile(0.95);
+        statistics.p99 = percentile(0.99);
+        statistics.p999 = percentile(0.999);
+        statistics.max = values.back();
+        return statistics;
+    }
+
+    Statistics cpuStatistics(const BenchmarkResults& results)
+    {
+        std::vector<float> times;
+        times.reserve(results.frames.size());
+        for (const auto& frame : results.frames)
+        {
+            times.push_back(frame.cpuMilliseconds);
+        }
+        return computeStatistics(std::move(times));
+    }
+
+    Statistics gpuStatistics(const BenchmarkResults& results)
+    {
+        std::vector<float> times;
+        times.reserve(results.frames.size());
+        for (const auto& frame : results.frames)
+        {
+            times.push_back(frame.gpuMilliseconds);
+        }
+        return computeStatistics(std::move(times));
+    }
+
+    std::string statisticsJson(const Statistics& statistics)
+    {
+        return fmt::format(R"({{"mean":{:.4f},"p50":{:.4f},"p95":{:.4f},"p99":{:.4f},"p99.9":{:.4f},"max":{:.4f}}})",
+                           statistics.mean, statistics.p50, statistics.p95, statistics.p99, statistics.p999,
+                           statistics.max);
+    }
+
+    float parseMilliseconds(const std::string& option, const std::string& value)
+    {
+        float milliseconds = std::stof(value);
+        if (!(milliseconds > 0.0f))
+        {
+            throw std::invalid_argument(option);
+        }
+        return milliseconds;
+    }
+}
+
+std::optional<std::string> CameraPath::loadFromFile(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        return fmt::format("Could not open camera path \"{}\".", path);
+    }
+
+    keyframes.clear();
+    std::string line;
+    for (unsigned int lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        trim(line);
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream stream(line);
+        Keyframe keyframe{};
+        if (!(stream >> keyframe.time >> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+                     >> keyframe.yaw >> keyframe.pitch))
+        {
+            return fmt::format("{}:{}: expected \"time x y z yaw pitch\".", path, lineNumber);
+        }
+        if (!keyframes.empty() && keyframe.time <= keyframes.back().time)
+        {
+            return fmt::format("{}:{}: keyframe times must increase.", path, lineNumber);
+        }
+        keyframes.push_back(keyframe);
+    }
+
+    if (keyframes.size() < 2)
+    {
+        return fmt::format("Camera path \"{}\" needs at least two keyframes.", path);
+    }
+    return {};
+}
+
+float CameraPath::getDuration() const
+{
+    return keyframes.empty() ? 0.0f : keyframes.back().time - keyframes.front().time;
+}
+
+void CameraPath::apply(Camera& camera, float time) const
+{
+    if (keyframes.empty())
+    {
+        return;
+    }
+
+    time = std::clamp(time + keyframes.front().time, keyframes.front().time, keyframes.back().time);
+    size_t next = 1;
+    while (next < keyframes.size() - 1 && keyframes[next].time < time)
+    {
+        next++;
+    }
+
+    // The end keyframes are repeated as outer control points.
+    const Keyframe& p0 = keyframes[next > 1 ? next - 2 : 0];
+    const Keyframe& p1 = keyframes[next - 1];
+    const Keyframe& p2 = keyframes[next];
+    const Keyframe& p3 = keyframes[std::min(next + 1, keyframes.size() - 1)];
+    float t = (time - p1.time) / (p2.time - p1.time);
+    auto spline = [t](auto a, auto b, auto c, auto d) {
+        return 0.5f * ((2.0f * b) + (c - a) * t + (2.0f * a - 5.0f * b + 4.0f * c - d) * t * t +
+                       (3.0f * b - a - 3.0f * c + d) * t * t * t);
+    };
+
+    camera.position = spline(p0.position, p1.position, p2.position, p3.position);
+    camera.setOrientation(spline(p0.yaw, p1.yaw, p2.yaw, p3.yaw),
+                          std::clamp(spline(p0.pitch, p1.pitch, p2.pitch, p3.pitch), -89.0f, 89.0f));
+}
+
+std::optional<std::string> parseBenchmarkOptions(int argc, char* argv[], BenchmarkOptions& options)
+{
+    bool hasOptions = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+        {
+            return fmt::format("Missing value for \"{}\". {}", option, USAGE);
+        }
+        std::string value = argv[++i];
+
+        try
+        {
+            if (option == "--benchmark")
+            {
+                options.enabled = true;
+                options.scene = value;
+            }
+            else if (option == "--frames" || option == "--warmup")
+            {
+                int frames = std::stoi(value);
+                if (frames < (option == "--frames" ? 1 : 0))
+                {
+                    throw std::invalid_argument(option);
+                }
+                (option == "--frames" ? options.frames : options.warmupFrames) = static_cast<unsigned int>(frames);
+            }
+            else if (option == "--path")
+            {
+                options.pathFile = value;
+            }
+            else if (option == "--output")
+            {
+                options.outputFile = value;
+            }
+            else if (option == "--resolution")
+            {
+                size_t separator = value.find('x');
+                if (separator == std::string::npos)
+                {
+                    throw std::invalid_argument(option);
+                }
+                options.resolution = { std::stoi(value.substr(0, separator)), std::stoi(value.substr(separator + 1)) };
+                if (options.resolution.x <= 0 || options.resolution.y <= 0)
+                {
+                    throw std::invalid_argument(option);
+                }
+            }
+            else if (option == "--max-cpu-p95")
+            {
+                options.maxCpuP95 = parseMilliseconds(option, value);
+            }
+            else if (option == "--max-cpu-p99")
+            {
+                options.maxCpuP99 = parseMilliseconds(option, value);
+            }
+            else if (option == "--max-gpu-p95")
+            {
+                options.maxGpuP95 = parseMilliseconds(option, value);
+            }
+            else if (option == "--max-gpu-p99")
+            {
+                options.maxGpuP99 = parseMilliseconds(option, value);
+            }
+            else
+            {
+                return fmt::format("Unknown option \"{}\". {}", option, USAGE);
+            }
+        }
+        catch (std::logic_error& ex)
+        {
+            return fmt::format("Invalid value \"{}\" for \"{}\".", value, option);
+        }
+        hasOptions = true;
+    }
+
+    if (hasOptions && !options.enabled)
+    {
+        return fmt::format("Benchmark options require --benchmark. {}", USAGE);
+    }
+    if (options.enabled && options.pathFile.empty())
+    {
+        options.pathFile = fmt::format("assets/benchmarks/{}.path", options.scene);
+    }
+    return {};
+}
+
+std::vector<std::string> checkBenchmarkThresholds(const BenchmarkOptions& options, const BenchmarkResults& results)
+{
+    Statistics cpu = cpuStatistics(results);
+    Statistics gpu = gpuStatistics(results);
+    const std::tuple<const char*, const std::optional<float>&, float> thresholds[] = {
+        { "CPU p95", options.maxCpuP95, cpu.p95 },
+        { "CPU p99", options.maxCpuP99, cpu.p99 },
+        { "GPU p95", options.maxGpuP95, gpu.p95 },
+        { "GPU p99", options.maxGpuP99, gpu.p99 }
+    };
+
+    std::vector<std::string> failures;
+    for (const auto& [name, limit, value] : thresholds)
+    {
+        if (limit && value > limit.value())
+        {
+            failures.push_back(fmt::format("{} frame time {:.3f} ms exceeds {:.3f} ms.", name, value, limit.value()));
+        }
+    }
+    return failures;
+}
+
+std::optional<std::string> writeBenchmarkReport(const BenchmarkOptions& options, const BenchmarkResults& results,
+                                                const std::vector<std::string>& failures)
+{
+    std::ofstream file(options.outputFile);
+    if (!file)
+    {
+        return fmt::format("Could not open \"{}\" for writing.", options.outputFile);
+    }
+
+    file << "{\n";
+    file << fmt::format(R"("version":"{}","renderer":"{}","scene":"{}","path":"{}","resolution":[{},{}],)",
+                        escapeJson(results.version), escapeJson(results.renderer), escapeJson(options.scene),
+                        escapeJson(options.pathFile), results.resolution.x, results.resolution.y) << "\n";
+    file << fmt::format(R"("warmupFrames":{},"frames":{},)", options.warmupFrames, results.frames.size()) << "\n";
+
+    file << "\"loadMilliseconds\":{";
+    for (size_t i = 0; i < results.loadTimes.size(); ++i)
+    {
+        file << fmt::format(R"({}"{}":{:.3f})", i > 0 ? "," : "", escapeJson(results.loadTimes[i].first),
+                            results.loadTimes[i].second);
+    }
+    file << "},\n";
+
+    file << "\"cpuMilliseconds\":" << statisticsJson(cpuStatistics(results)) << ",\n";
+    file << "\"gpuMilliseconds\":" << statisticsJson(gpuStatistics(results)) << ",\n";
+
+    // Mean and maximum of each counter per frame. All zero unless built with KUMIGAME_GL_COUNTERS.
+    file << fmt::format(R"("counters":{{"enabled":{})", GlCounters::ENABLED);
+    for (const auto& [name, member] : COUNTERS)
+    {
+        double sum = 0.0;
+        uint64_t max = 0;
+        for (const auto& frame : results.frames)
+        {
+            sum += static_cast<double>(frame.counts.*member);
+            max = std::max(max, frame.counts.*member);
+        }
+        double mean = results.frames.empty() ? 0.0 : sum / static_cast<double>(results.frames.size());
+        file << fmt::format(R"(,"{}":{{"mean":{:.2f},"max":{}}})", name, mean, max);
+    }
+    file << "},\n";
+
+    file << "\"memoryBytes\":{\"gpu\":{";
+    for (size_t i = 0; i < results.memory.gpu.size(); ++i)
+    {
+        file << fmt::format(R"({}"{}":{})", i > 0 ? "," : "",
+                            MemoryTracker::getCategoryName(static_cast<MemoryCategory>(i)), results.memory.gpu[i]);
+    }
+    file << "},\"heap\":{";
+    for (size_t i = 0; i < results.memory.cpu.size(); ++i)
+    {
+        file << fmt::format(R"({}"{}":{})", i > 0 ? "," : "",
+                            MemoryTracker::getCategoryName(static_cast<MemoryCategory>(i)), results.memory.cpu[i]);
+    }
+    file << "}},\n";
+
+    file << "\"thresholds\":{";
+    const std::pair<const char*, const std::optional<float>&> thresholds[] = {
+        { "maxCpuP95", options.maxCpuP95 },
+        { "maxCpuP99", options.maxCpuP99 },
+        { "maxGpuP95", options.maxGpuP95 },
+        { "maxGpuP99", options.maxGpuP99 }
+    };
+    bool first = true;
+    for (const auto& [name, limit] : thresholds)
+    {
+        if (limit)
+        {
+            file << fmt::format(R"({}"{}":{:.3f})", first ? "" : ",", name, limit.value());
+            first = false;
+        }
+    }
+    file << fmt::format("}},\n\"passed\":{},\n\"failures\":[", failures.empty());
+    for (size_t i = 0; i < failures.size(); ++i)
+    {
+        file << fmt::format(R"({}"{}")", i > 0 ? "," : "", escapeJson(failures[i]));
+    }
+    file << "],\n";
+
+    // One entry per measured frame, in path order.
+    file << "\"frameTimes\":[";
+    for (size_t i = 0; i < results.frames.size(); ++i)
+    {
+        const BenchmarkFrame& frame = results.frames[i];
+        file << (i > 0 ? "," : "") << "\n" << fmt::format(R"({{"cpu":{:.4f},"gpu":{:.4f},"drawCalls":{}}})",
+                                                         frame.cpuMilliseconds, frame.gpuMilliseconds,
+                                                         frame.counts.drawCalls);
+    }
+    file << "\n]\n}\n";
+
+    if (!file)
+    {
+        return fmt::format("Failed to write \"{}\".", options.outputFile);
+    }
+    return {};
+}
@@ -0,0 +1,84 @@
+#ifndef KUMIGAME_DEBUG_BENCHMARK_HPP
+#define KUMIGAME_DEBUG_BENCHMARK_HPP
+
+#include "glCounters.hpp"
+#include "memoryTracker.hpp"
+#include "../camera.hpp"
+#include <glm/glm.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct BenchmarkOptions
+{
+    bool enabled = false;
+    std::string scene;
+    std::string pathFile;
+    std::string outputFile = "logs/benchmark.json";
+    unsigned int frames = 1000;
+    // Rendered at the start of the path before measuring, so shader compilation and first uploads are not counted.
+    unsigned int warmupFrames = 60;
+    // Zero keeps the window size from the settings.
+    glm::ivec2 resolution{};
+
+    // Frame time limits in milliseconds. The benchmark fails if any is exceeded.
+    std::optional<float> maxCpuP95;
+    std::optional<float> maxCpuP99;
+    std::optional<float> maxGpuP95;
+    std::optional<float> maxGpuP99;
+};
+
+struct BenchmarkFrame
+{
+    float cpuMilliseconds;
+    // Latest GPU frame time available at the end of the frame. GPU times are read back a few frames late.
+    float gpuMilliseconds;
+    GlCounters::Counts counts;
+};
+
+struct BenchmarkResults
+{
+    std::string version;
+    std::string renderer;
+    glm::ivec2 resolution{};
+    std::vector<std::pair<std::string, double>> loadTimes;
+    std::vector<BenchmarkFrame> frames;
+    MemoryTracker::Usage memory;
+};
+
+/**
+ * @brief A camera flight through keyframes, interpolated with Catmull-Rom splines.
+ *
+ * Path files have one keyframe per line: "time x y z yaw pitch", with time in seconds and angles in degrees. Empty
+ * lines and lines starting with # are ignored. Keyframes must be in order of time.
+ */
+class CameraPath
+{
+public:
+    std::optional<std::string> loadFromFile(const std::string& path);
+
+    float getDuration() const;
+    // @brief Moves the camera to where the path is at the given time, clamped to the ends of the path.
+    void apply(Camera& camera, float time) const;
+
+private:
+    struct Keyframe
+    {
+        float time;
+        glm::vec3 position;
+        float yaw;
+        float pitch;
+    };
+
+    std::vector<Keyframe> keyframes;
+};
+
+// @brief Reads --benchmark and its options from the command line. Leaves options.enabled false without --benchmark.
+std::optional<std::string> parseBenchmarkOptions(int argc, char* argv[], BenchmarkOptions& options);
+// @brief Returns a description of every threshold the results exceed.
+std::vector<std::string> checkBenchmarkThresholds(const BenchmarkOptions& options, const BenchmarkResults& results);
+std::optional<std::string> writeBenchmarkReport(const BenchmarkOptions& options, const BenchmarkResults& results,
+                                                const std::vector<std::string>& failures);
+
+#endif //KUMIGAME_DEBUG_BENCHMARK_HPP
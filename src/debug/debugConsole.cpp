@@ -78,13 +78,13 @@ DebugConsole::DebugConsole(std::shared_ptr<TextRenderer> &textRenderer, glm::vec
     }, GLFW_KEY_UP, GLFW_REPEAT);
 
     // Add text to input.
-    for (int codePoint = 0; codePoint <= 0x007F; ++codePoint)
-    {
-        Keyboard::addCharBinding([this, codePoint]() {
-            if (codePoint == '`') return;
+    Keyboard::addCharCallback([this](unsigned int codePoint) {
+        // Only ASCII is rendered. The grave accent toggles the console.
+        if (codePoint <= 0x007F && codePoint != '`')
+        {
             inputCharacter(codePoint);
-        }, codePoint);
-    }
+        }
+    });
     Keyboard::addKeyBinding([this](){
         inputCharacter('\t');
     }, GLFW_KEY_TAB, GLFW_PRESS);
@@ -98,7 +98,13 @@ void DebugConsole::update()
     // Print command response.
     if (!command.response.empty())
     {
-        output.emplace_back(command.response);
+        // Responses can span several lines, e.g. tables.
+        std::istringstream response(command.response);
+        std::string line;
+        while (std::getline(response, line))
+        {
+            addOutput(line);
+        }
         LOG_INFO("Debug Console: {}", command.response);
         command.response.clear();
     }
@@ -111,25 +117,46 @@ void DebugConsole::update()
             if (command[0] == "help")
             {
                 const int width = 40;
-                output.emplace_back(columnString("help [page number]", "Print command list.", width));
-                output.emplace_back(columnString("exit|close|quit|q", "Close the console window.", width));
-                output.emplace_back(columnString("exit|close|quit|q game", "Exit the game.", width));
-                output.emplace_back(columnString("clear", "Clear the console.", width));
-                output.emplace_back(columnString("toggle stats", "Toggle FPS, version, and other statistics.", width));
-                output.emplace_back(columnString("toggle line|toggle wireframe", "Toggle wireframe polygon mode.", width));
-                output.emplace_back(columnString("toggle point", "Toggle point polygon mode.", width));
-                output.emplace_back(columnString("toggle fill", "Toggle fill polygon mode.", width));
-                output.emplace_back(columnString("settings save", "Save settings.", width));
-                output.emplace_back(columnString("set window [width:int] [height:int]", "Set the width and height of the window.", width));
-                output.emplace_back(columnString("set fullscreen [bool]", "Toggle window fullscreen.", width));
-                output.emplace_back(columnString("set vsync [bool]", "Turn vSync on or off.", width));
-                output.emplace_back(columnString("set fov [fov:float]", "Set player's field-of-view.", width));
-                output.emplace_back(columnString("Page 1/1", "", width));
+                addOutput(columnString("help [page number]", "Print command list.", width));
+                addOutput(columnString("exit|close|quit|q", "Close the console window.", width));
+                addOutput(columnString("exit|close|quit|q game", "Exit the game.", width));
+                addOutput(columnString("clear", "Clear the console.", width));
+                addOutput(columnString("toggle stats", "Toggle FPS, version, and other statistics.", width));
+                addOutput(columnString("toggle line|toggle wireframe", "Toggle wireframe polygon mode.", width));
+                addOutput(columnString("toggle point", "Toggle point polygon mode.", width));
+                addOutput(columnString("toggle fill", "Toggle fill polygon mode.", width));
+                addOutput(columnString("settings save", "Save settings.", width));
+                addOutput(columnString("profile capture [frames:int]", "Write a CPU trace of the next frames.", width));
+                addOutput(columnString("mem|memory", "Print GPU and heap memory use by category.", width));
+                addOutput(columnString("gldebug", "Print how often each OpenGL debug message was reported.", width));
+                addOutput(columnString("calibrate", "Measure graphics presets and keep the best that hits the target.", width));
+                addOutput(columnString("flight dump", "Write the last seconds of frames, scopes and logs to logs/.", width));
+                addOutput(columnString("input record", "Record input to logs/input.rec.", width));
+                addOutput(columnString("input replay", "Replay the recorded input frame by frame.", width));
+                addOutput(columnString("input replay profile", "Replay the recorded input and capture a CPU trace of it.", width));
+                addOutput(columnString("input stop", "Stop recording or replaying input.", width));
+                addOutput(columnString("set window [width:int] [height:int]", "Set the width and height of the window.", width));
+                addOutput(columnString("set fullscreen [bool]", "Toggle window fullscreen.", width));
+                addOutput(columnString("set vsync [bool]", "Turn vSync on or off.", width));
+                addOutput(columnString("set glsync [bool]", "Report OpenGL messages inside the call, for backtraces.", width));
+                addOutput(columnString("set fov [fov:float]", "Set player's field-of-view.", width));
+                addOutput(columnString("set supersampling [scale:float]", "Set the render resolution scale.", width));
+                addOutput(columnString("set aa [mode]", "Set anti-aliasing to off, msaa2, msaa4, msaa8 or fxaa.", width));
+                addOutput(columnString("set pointlights [count:int]", "Set how many point lights shade the scene, 1 to 4.", width));
+                addOutput(columnString("set postprocess [effect] [bool]", "Toggle blur, sharpen, edge, greyscale or invert.", width));
+                addOutput(columnString("set blur [radius:int]", "Set the blur radius in pixels.", width));
+                addOutput(columnString("set dynamicres [bool]", "Scale resolution to hit the target frame time.", width));
+                addOutput(columnString("set targetframetime [ms:float]", "Set the dynamic resolution GPU time target.", width));
+                addOutput(columnString("set taa [bool]", "Render below native resolution and upsample temporally.", width));
+                addOutput(columnString("set taascale [scale:float]", "Set the temporal upsampling render scale.", width));
+                addOutput(columnString("set vrambudget [MB:int]", "Warn when GPU memory use exceeds this. 0 disables.", width));
+                addOutput(columnString("Page 1/1", "", width));
                 command.processed = true;
             }
             else if (command[0] == "clear")
             {
                 output.clear();
+                printedOutput.clear();
                 command.processed = true;
             }
             else if (command[0] == "exit" || command[0] == "close" || command[0] == "quit" || command[0] == "q")
@@ -142,7 +169,7 @@ void DebugConsole::update()
 
     if (!(command.processed || command.args.empty()))
     {
-        output.emplace_back(fmt::format("No such command \"{}\".", command.input));
+        addOutput(fmt::format("No such command \"{}\".", command.input));
         command.processed = true;
     }
 
@@ -152,6 +179,7 @@ void DebugConsole::update()
     {
         output.erase(output.begin(), output.end() - MAX_OUTPUT_SIZE);
         output.pop_front();
+        printedOutput.erase(printedOutput.begin(), printedOutput.end() - (MAX_OUTPUT_SIZE - 1));
     }
 }
 
@@ -159,13 +187,6 @@ void DebugConsole::render(glm::vec3 textColor)
 {
     if (!hidden)
     {
-        glDisable(GL_DEPTH_TEST); // Keep text on top.
-
-        // Prevent text from being drawn as wireframe/points.
-        int polygonMode;
-        glGetIntegerv(GL_POLYGON_MODE, &polygonMode);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
         std::string inputPrint = fmt::format(">{}", input);
 
         if (cursorPosition > inputPrint.length() - 1)
@@ -177,34 +198,38 @@ void DebugConsole::render(glm::vec3 textColor)
             inputPrint.insert(cursorPosition + 1, "|");
         }
 
-        for (unsigned long long i = 0; i < output.size(); ++i)
+        for (size_t i = 0; i < printedOutput.size(); ++i)
         {
-            auto index = output.size() - 1 - i;
-            auto outputPrint = fmt::format(">{}", output[index]);
-            size_t size = outputPrint.size();
-            for (size_t i = 0; i < size; ++i)
-            {
-                if (outputPrint[i] == '\t')
-                {
-                    size_t next = (i + 3) & ~0x03;
-                    if (i % 4 == 0)
-                    {
-                        next += 4;
-                    }
-                    size_t count = next - i;
-                    outputPrint.insert(i + 1, count, ' ');
-                    size += count;
-                }
-            }
-            textRenderer->render(outputPrint, position - glm::vec2(0.0f, static_cast<float>(i + 1) * 20.0f),
+            auto index = printedOutput.size() - 1 - i;
+            textRenderer->render(printedOutput[index], position - glm::vec2(0.0f, static_cast<float>(i + 1) * 20.0f),
                 1.0f, glm::vec4(textColor, 0.5f));
         }
 
         textRenderer->render(inputPrint, position, 1.0f, glm::vec4(textColor, 0.7f));
+    }
+}
+
+void DebugConsole::addOutput(const std::string& line)
+{
+    output.push_back(line);
 
-        glPolygonMode(GL_FRONT_AND_BACK, polygonMode);
-        glEnable(GL_DEPTH_TEST); // Restore depth testing.
+    auto outputPrint = fmt::format(">{}", line);
+    size_t size = outputPrint.size();
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (outputPrint[i] == '\t')
+        {
+            size_t next = (i + 3) & ~0x03;
+            if (i % 4 == 0)
+            {
+                next += 4;
+            }
+            size_t count = next - i;
+            outputPrint.insert(i + 1, count, ' ');
+            size += count;
+        }
     }
+    printedOutput.push_back(std::move(outputPrint));
 }
 
 void DebugConsole::backSpace()
@@ -297,7 +322,7 @@ void DebugConsole::runCommand(std::string commandString)
     // Split command into a vector.
     command.args = split(commandString);
 
-    output.emplace_back(commandString);
+    addOutput(commandString);
     command.processed = false;
 
     input.clear();
@@ -51,9 +51,12 @@ private:
     std::shared_ptr<TextRenderer> textRenderer;
     std::string input;
     std::deque<std::string> output;
+    // Output lines as drawn, with the prompt prepended and tabs expanded when the line is added.
+    std::deque<std::string> printedOutput;
     size_t cursorPosition = 0;
 
     void runCommand(std::string commandString);
+    void addOutput(const std::string& line);
 
     void backSpace();
     void deleteChar();
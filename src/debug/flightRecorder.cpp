@@ -0,0 +1,688 @@
+#include "flightRecorder.hpp"
+#include "log.hpp"
+#include "profiler.hpp"
+#include "../util/clock.hpp"
+#include "../util/string.hpp"
+#include <spdlog/details/null_mutex.h>
+#include <spdlog/sinks/base_sink.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const size_t FRAME_CAPACITY = 1 << 13;
+    const size_t ZONE_CAPACITY = 1 << 16;
+    const size_t LOG_CAPACITY = 1 << 10;
+    const size_t LOG_LINE_SIZE = 240;
+    // The median frame time is taken over this many frames, and updated every MEDIAN_INTERVAL frames.
+    const size_t MEDIAN_FRAMES = 255;
+    const size_t MEDIAN_INTERVAL = 30;
+    // The crash dump is written in pieces of this size.
+    const size_t CRASH_BUFFER_SIZE = 1 << 16;
+
+    struct Frame
+    {
+        int64_t end;
+        float cpuMilliseconds;
+        float gpuMilliseconds;
+        GlCounters::Counts counts;
+    };
+
+    struct Zone
+    {
+        const char* name;
+        uint32_t thread;
+        int64_t start;
+        int64_t end;
+    };
+
+    struct LogLine
+    {
+        int64_t time;
+        spdlog::level::level_enum level;
+        size_t length;
+        std::array<char, LOG_LINE_SIZE> text;
+    };
+
+    // Fixed-size ring that overwrites its oldest item when full.
+    template<typename T, size_t CAPACITY>
+    struct Ring
+    {
+        std::array<T, CAPACITY> items;
+        uint64_t next = 0;
+
+        void push(const T& item)
+        {
+            items[next % CAPACITY] = item;
+            next++;
+        }
+
+        size_t size() const
+        {
+            return static_cast<size_t>(std::min<uint64_t>(next, CAPACITY));
+        }
+
+        // oldest first
+        const T& operator[](size_t index) const
+        {
+            return items[(next - size() + index) % CAPACITY];
+        }
+    };
+
+    // Ring of log lines that the crash handler can read without a lock. Writers hold logMutex. Each slot's sequence
+    // is odd while its line is being written, so a reader that does not hold the lock can skip torn lines.
+    struct LogRing
+    {
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence = 0;
+            LogLine line;
+        };
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "The crash handler reads the sequence numbers.");
+
+        std::array<Slot, LOG_CAPACITY> slots;
+        std::atomic<uint64_t> next = 0;
+
+        void push(const LogLine& line)
+        {
+            uint64_t index = next.load(std::memory_order_relaxed);
+            Slot& slot = slots[index % LOG_CAPACITY];
+            slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.line = line;
+            slot.sequence.store(2 * index + 2, std::memory_order_release);
+            next.store(index + 1, std::memory_order_release);
+        }
+
+        // Line numbers from begin() to end() are in the ring, oldest first.
+        uint64_t begin() const
+        {
+            uint64_t last = end();
+            return last - std::min<uint64_t>(last, LOG_CAPACITY);
+        }
+
+        uint64_t end() const
+        {
+            return next.load(std::memory_order_acquire);
+        }
+
+        // Copies line number index. Fails if it has been overwritten or is being written.
+        bool read(uint64_t index, LogLine& line) const
+        {
+            const Slot& slot = slots[index % LOG_CAPACITY];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * index + 2)
+            {
+                return false;
+            }
+            line = slot.line;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.sequence.load(std::memory_order_relaxed) == sequence;
+        }
+    };
+
+    struct Snapshot
+    {
+        std::string reason;
+        std::string path;
+        int64_t start = 0;
+        std::vector<Frame> frames;
+        std::vector<Zone> zones;
+        std::vector<LogLine> logs;
+        std::vector<std::pair<uint32_t, std::string>> threadNames;
+    };
+
+    std::atomic<bool> enabled = false;
+    int64_t windowLength = 0;
+    float hitchMultiple = 0.0f;
+
+    // Frames and zones are only touched by the main thread; log lines arrive on the logging thread.
+    Ring<Frame, FRAME_CAPACITY> frames;
+    Ring<Zone, ZONE_CAPACITY> zones;
+    std::mutex logMutex;
+    LogRing logs;
+
+    float medianMilliseconds = 0.0f;
+    std::array<float, MEDIAN_FRAMES> medianScratch;
+    int64_t lastHitch = 0;
+
+    // Owned by the writer thread while writing is set.
+    Snapshot snapshot;
+    std::thread writer;
+    std::atomic<bool> writing = false;
+    // Set by enable(), so the crash handler has nothing to allocate.
+    char crashPath[64] = {};
+    char crashBuffer[CRASH_BUFFER_SIZE];
+
+    class FlightRecorderSink : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+    {
+    protected:
+        void sink_it_(const spdlog::details::log_msg& msg) override
+        {
+            if (!enabled.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            LogLine line;
+            line.time = nowNanoseconds();
+            line.level = msg.level;
+            line.length = std::min(msg.payload.size(), LOG_LINE_SIZE);
+            std::memcpy(line.text.data(), msg.payload.data(), line.length);
+
+            std::lock_guard<std::mutex> lock(logMutex);
+            logs.push(line);
+        }
+
+        void flush_() override
+        {
+        }
+    };
+
+    std::string makePath(const std::string& reason)
+    {
+        return fmt::format("logs/flight.{}.{}.json", reason, static_cast<int64_t>(std::time(nullptr)));
+    }
+
+    void reserve(Snapshot& target)
+    {
+        target.frames.reserve(FRAME_CAPACITY);
+        target.zones.reserve(ZONE_CAPACITY);
+        target.logs.reserve(LOG_CAPACITY);
+    }
+
+    // Copies the last windowLength nanoseconds of the rings.
+    void takeSnapshot(Snapshot& target)
+    {
+        target.start = nowNanoseconds() - windowLength;
+        target.frames.clear();
+        target.zones.clear();
+        target.logs.clear();
+
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            if (frames[i].end >= target.start)
+            {
+                target.frames.push_back(frames[i]);
+            }
+        }
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            if (zones[i].end >= target.start)
+            {
+                target.zones.push_back(zones[i]);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(logMutex);
+            LogLine line;
+            for (uint64_t i = logs.begin(); i < logs.end(); ++i)
+            {
+                if (logs.read(i, line) && line.time >= target.start)
+                {
+                    target.logs.push_back(line);
+                }
+            }
+        }
+
+        target.threadNames = Profiler::getThreadNames();
+    }
+
+    std::optional<std::string> writeSnapshot(const Snapshot& source)
+    {
+        std::ofstream file(source.path);
+        if (!file)
+        {
+            return fmt::format("Could not open \"{}\" for writing.", source.path);
+        }
+
+        // Scopes open at the start of the window begin before it.
+        int64_t origin = source.start;
+        for (const Zone& zone : source.zones)
+        {
+            origin = std::min(origin, zone.start);
+        }
+        auto microseconds = [origin](int64_t time) {
+            return static_cast<double>(time - origin) / 1000.0;
+        };
+
+        // Chrome trace event format, like the profiler's captures: scopes are complete ("X") events, frames are
+        // counters ("C") placed at the start of the frame and log lines are instant ("i") events.
+        file << fmt::format(R"({{"displayTimeUnit":"ms","otherData":{{"reason":"{}"}},"traceEvents":[)",
+                            escapeJson(source.reason));
+        bool first = true;
+        auto separator = [&first]() {
+            const char* result = first ? "\n" : ",\n";
+            first = false;
+            return result;
+        };
+
+        for (const auto& [id, name] : source.threadNames)
+        {
+            file << separator() << fmt::format(
+                R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})", id, escapeJson(name));
+        }
+        for (const Zone& zone : source.zones)
+        {
+            file << separator() << fmt::format(
+                R"({{"name":"{}","cat":"cpu","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                escapeJson(zone.name), zone.thread, microseconds(zone.start),
+                static_cast<double>(zone.end - zone.start) / 1000.0);
+        }
+        for (const Frame& frame : source.frames)
+        {
+            double start = microseconds(frame.end) - 1000.0 * frame.cpuMilliseconds;
+            file << separator() << fmt::format(
+                R"({{"name":"frame ms","ph":"C","pid":1,"ts":{:.3f},"args":{{"cpu":{:.3f},"gpu":{:.3f}}}}})",
+                start, frame.cpuMilliseconds, frame.gpuMilliseconds);
+            if (GlCounters::ENABLED)
+            {
+                const GlCounters::Counts& counts = frame.counts;
+                file << separator() << fmt::format(
+                    R"({{"name":"gl","ph":"C","pid":1,"ts":{:.3f},"args":{{"draws":{},"dispatches":{},"primitives":{},)"
+                    R"("programBinds":{},"vertexArrayBinds":{},"textureBinds":{},"uniforms":{},"bufferBytes":{},)"
+                    R"("textureBytes":{}}}}})",
+                    start, counts.drawCalls, counts.dispatches, counts.primitives, counts.programBinds,
+                    counts.vertexArrayBinds, counts.textureBinds, counts.uniformUploads, counts.bufferBytes,
+                    counts.textureBytes);
+            }
+        }
+        for (const LogLine& line : source.logs)
+        {
+            spdlog::string_view_t level = spdlog::level::to_string_view(line.level);
+            file << separator() << fmt::format(
+                R"({{"name":"{}","cat":"log","ph":"i","s":"g","pid":1,"tid":0,"ts":{:.3f},"args":{{"level":"{}"}}}})",
+                escapeJson(std::string(line.text.data(), line.length)), microseconds(line.time),
+                std::string(level.data(), level.size()));
+        }
+        file << "\n]}\n";
+
+        if (!file)
+        {
+            return fmt::format("Failed to write \"{}\".", source.path);
+        }
+        return {};
+    }
+
+    void updateMedian()
+    {
+        for (size_t i = 0; i < MEDIAN_FRAMES; ++i)
+        {
+            medianScratch[i] = frames[frames.size() - MEDIAN_FRAMES + i].cpuMilliseconds;
+        }
+        auto middle = medianScratch.begin() + MEDIAN_FRAMES / 2;
+        std::nth_element(medianScratch.begin(), middle, medianScratch.end());
+        medianMilliseconds = *middle;
+    }
+
+    // Writes the crash dump with nothing but arithmetic, memcpy and write(), which are async-signal-safe: a crash
+    // inside the allocator, or while holding a lock, must still end the process rather than hang it. The dump has the
+    // same events as other dumps, without thread names, and without log lines if the logging thread held their lock.
+    class CrashWriter
+    {
+    public:
+        explicit CrashWriter(int file)
+            : file(file)
+        {
+        }
+
+        ~CrashWriter()
+        {
+            flush();
+        }
+
+        void append(const char* text, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                if (used == CRASH_BUFFER_SIZE)
+                {
+                    flush();
+                }
+                crashBuffer[used++] = text[i];
+            }
+        }
+
+        void append(const char* text)
+        {
+            append(text, std::strlen(text));
+        }
+
+        // Appends the text as the content of a JSON string.
+        void appendEscaped(const char* text, size_t length)
+        {
+            const char* hexDigits = "0123456789abcdef";
+            for (size_t i = 0; i < length; ++i)
+            {
+                auto u = static_cast<unsigned char>(text[i]);
+                if (text[i] == '"' || text[i] == '\\')
+                {
+                    char escaped[] = { '\\', text[i] };
+                    append(escaped, sizeof(escaped));
+                }
+                else if (u < 0x20)
+                {
+                    char escaped[] = { '\\', 'u', '0', '0', hexDigits[u >> 4], hexDigits[u & 0x0F] };
+                    append(escaped, sizeof(escaped));
+                }
+                else
+                {
+                    append(&text[i], 1);
+                }
+            }
+        }
+
+        void appendInteger(uint64_t value)
+        {
+            char digits[20];
+            size_t count = 0;
+            do
+            {
+                digits[count++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value > 0);
+            while (count > 0)
+            {
+                append(&digits[--count], 1);
+            }
+        }
+
+        // Appends thousandths / 1000 with three decimals, e.g. nanoseconds as microseconds.
+        void appendFixed(int64_t thousandths)
+        {
+            if (thousandths < 0)
+            {
+                append("-");
+                thousandths = -thousandths;
+            }
+            appendInteger(static_cast<uint64_t>(thousandths / 1000));
+            char decimals[] = { '.', static_cast<char>('0' + thousandths / 100 % 10),
+                                static_cast<char>('0' + thousandths / 10 % 10), static_cast<char>('0' + thousandths % 10) };
+            append(decimals, sizeof(decimals));
+        }
+
+        void separator()
+        {
+            append(first ? "\n" : ",\n");
+            first = false;
+        }
+
+    private:
+        int file;
+        size_t used = 0;
+        bool first = true;
+
+        void flush()
+        {
+            size_t written = 0;
+            while (written < used)
+            {
+#ifdef _WIN32
+                auto result = _write(file, crashBuffer + written, static_cast<unsigned int>(used - written));
+#else
+                auto result = write(file, crashBuffer + written, used - written);
+#endif
+                if (result <= 0)
+                {
+                    break;
+                }
+                written += static_cast<size_t>(result);
+            }
+            used = 0;
+        }
+    };
+
+    void writeCrashDump()
+    {
+#ifdef _WIN32
+        int file = _open(crashPath, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+        int file = open(crashPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+        if (file < 0)
+        {
+            return;
+        }
+
+        int64_t start = nowNanoseconds() - windowLength;
+        int64_t origin = start;
+        for (size_t i = 0; i < zones.size(); ++i)
+        {
+            if (zones[i].end >= start)
+            {
+                origin = std::min(origin, zones[i].start);
+            }
+        }
+
+        {
+            CrashWriter writer(file);
+            writer.append(R"({"displayTimeUnit":"ms","otherData":{"reason":"crash"},"traceEvents":[)");
+            for (size_t i = 0; i < zones.size(); ++i)
+            {
+                const Zone& zone = zones[i];
+                if (zone.end < start)
+                {
+                    continue;
+                }
+                writer.separator();
+                writer.append(R"({"name":")");
+                writer.appendEscaped(zone.name, std::strlen(zone.name));
+                writer.append(R"(","cat":"cpu","ph":"X","pid":1,"tid":)");
+                writer.appendInteger(zone.thread);
+                writer.append(R"(,"ts":)");
+                writer.appendFixed(zone.start - origin);
+                writer.append(R"(,"dur":)");
+                writer.appendFixed(zone.end - zone.start);
+                writer.append("}");
+            }
+            for (size_t i = 0; i < frames.size(); ++i)
+            {
+                const Frame& frame = frames[i];
+                if (frame.end < start)
+                {
+                    continue;
+                }
+                int64_t frameStart = frame.end - origin - static_cast<int64_t>(frame.cpuMilliseconds * 1e6f);
+                writer.separator();
+                writer.append(R"({"name":"frame ms","ph":"C","pid":1,"ts":)");
+                writer.appendFixed(frameStart);
+                writer.append(R"(,"args":{"cpu":)");
+                writer.appendFixed(static_cast<int64_t>(frame.cpuMilliseconds * 1000.0f));
+                writer.append(R"(,"gpu":)");
+                writer.appendFixed(static_cast<int64_t>(frame.gpuMilliseconds * 1000.0f));
+                writer.append("}}");
+                if (GlCounters::ENABLED)
+                {
+                    const GlCounters::Counts& counts = frame.counts;
+                    const std::pair<const char*, uint64_t> values[] = {
+                        { R"("draws":)", counts.drawCalls },
+                        { R"(,"dispatches":)", counts.dispatches },
+                        { R"(,"primitives":)", counts.primitives },
+                        { R"(,"programBinds":)", counts.programBinds },
+                        { R"(,"vertexArrayBinds":)", counts.vertexArrayBinds },
+                        { R"(,"textureBinds":)", counts.textureBinds },
+                        { R"(,"uniforms":)", counts.uniformUploads },
+                        { R"(,"bufferBytes":)", counts.bufferBytes },
+                        { R"(,"textureBytes":)", counts.textureBytes }
+                    };
+                    writer.separator();
+                    writer.append(R"({"name":"gl","ph":"C","pid":1,"ts":)");
+                    writer.appendFixed(frameStart);
+                    writer.append(R"(,"args":{)");
+                    for (const auto& [key, value] : values)
+                    {
+                        writer.append(key);
+                        writer.appendInteger(value);
+                    }
+                    writer.append("}}");
+                }
+            }
+            // Locking logMutex is not allowed in a signal handler and could hang if the crashing thread holds it, so
+            // the lines are read without it, skipping any that are being written.
+            LogLine line;
+            uint64_t end = logs.end();
+            for (uint64_t i = logs.begin(); i < end; ++i)
+            {
+                if (!logs.read(i, line) || line.time < start)
+                {
+                    continue;
+                }
+                spdlog::string_view_t level = spdlog::level::to_string_view(line.level);
+                writer.separator();
+                writer.append(R"({"name":")");
+                writer.appendEscaped(line.text.data(), line.length);
+                writer.append(R"(","cat":"log","ph":"i","s":"g","pid":1,"tid":0,"ts":)");
+                writer.appendFixed(line.time - origin);
+                writer.append(R"(,"args":{"level":")");
+                writer.append(level.data(), level.size());
+                writer.append(R"("}})");
+            }
+            writer.append("\n]}\n");
+        }
+
+#ifdef _WIN32
+        _close(file);
+#else
+        close(file);
+#endif
+    }
+
+    void onCrash(int signal)
+    {
+        static std::atomic<bool> crashed = false;
+        if (!crashed.exchange(true))
+        {
+#ifndef _WIN32
+            // Should the dump hang anyway, SIGALRM ends the process.
+            alarm(2);
+#endif
+            writeCrashDump();
+        }
+
+        // Let the default handler end the process, so the exit status and core dump are as without the recorder.
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+}
+
+void FlightRecorder::enable(float seconds, float hitchFactor)
+{
+    windowLength = static_cast<int64_t>(static_cast<double>(seconds) * 1e9);
+    hitchMultiple = hitchFactor;
+
+    // Allocate everything a dump needs now, rather than during a hitch or a crash.
+    reserve(snapshot);
+    std::string path = makePath("crash");
+    std::memcpy(crashPath, path.c_str(), std::min(path.size() + 1, sizeof(crashPath) - 1));
+    for (int signal : { SIGSEGV, SIGABRT, SIGFPE, SIGILL })
+    {
+        std::signal(signal, onCrash);
+    }
+
+    enabled.store(true, std::memory_order_relaxed);
+    Profiler::setContinuous(true);
+    LOG_INFO("Flight recorder keeps the last {} s and dumps frames over {} times the median.", seconds, hitchFactor);
+}
+
+bool FlightRecorder::isEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+void FlightRecorder::recordZone(const char* name, uint32_t thread, int64_t start, int64_t end)
+{
+    zones.push({ name, thread, start, end });
+}
+
+void FlightRecorder::endFrame(float cpuMilliseconds, float gpuMilliseconds, const GlCounters::Counts& counts)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    int64_t now = nowNanoseconds();
+    frames.push({ now, cpuMilliseconds, gpuMilliseconds, counts });
+
+    // One dump per window, so the dumps of a stutter do not overlap.
+    if (medianMilliseconds > 0.0f && cpuMilliseconds > hitchMultiple * medianMilliseconds &&
+        (lastHitch == 0 || now - lastHitch > windowLength))
+    {
+        lastHitch = now;
+        LOG_WARN("Hitch: frame took {:.2f} ms, {:.1f} times the median of {:.2f} ms.", cpuMilliseconds,
+                 cpuMilliseconds / medianMilliseconds, medianMilliseconds);
+        if (auto result = dump("hitch"))
+        {
+            LOG_WARN("Flight recorder: {}", result.value());
+        }
+    }
+
+    if (frames.next % MEDIAN_INTERVAL == 0 && frames.size() >= MEDIAN_FRAMES)
+    {
+        updateMedian();
+    }
+}
+
+std::optional<std::string> FlightRecorder::dump(const std::string& reason)
+{
+    if (!isEnabled())
+    {
+        return "The flight recorder is disabled.";
+    }
+    if (writing.load(std::memory_order_acquire))
+    {
+        return "A dump is still being written.";
+    }
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+
+    takeSnapshot(snapshot);
+    snapshot.reason = reason;
+    snapshot.path = makePath(reason);
+    writing.store(true, std::memory_order_relaxed);
+    writer = std::thread([]() {
+        if (auto result = writeSnapshot(snapshot))
+        {
+            LOG_ERROR("Flight recorder: {}", result.value());
+        }
+        else
+        {
+            LOG_INFO("Wrote {} frames of flight recording to \"{}\".", snapshot.frames.size(), snapshot.path);
+        }
+        writing.store(false, std::memory_order_release);
+    });
+    return {};
+}
+
+void FlightRecorder::shutdown()
+{
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+}
+
+std::shared_ptr<spdlog::sinks::sink> FlightRecorder::getLogSink()
+{
+    static auto sink = std::make_shared<FlightRecorderSink>();
+    return sink;
+}
@@ -0,0 +1,44 @@
+#ifndef KUMIGAME_DEBUG_FLIGHT_RECORDER_HPP
+#define KUMIGAME_DEBUG_FLIGHT_RECORDER_HPP
+
+#include "glCounters.hpp"
+#include <spdlog/sinks/sink.h>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+/**
+ * @brief Keeps the last seconds of frame times, profiler scopes, GL counters and log lines, and writes them out when
+ * something goes wrong.
+ *
+ * Everything is kept in rings allocated once at startup, so recording a frame copies a few values and never
+ * allocates. While enabled, the profiler records every PROFILE_SCOPE() and hands the scopes to the recorder once per
+ * frame. A frame taking longer than the hitch factor times the median frame time writes a dump from a background
+ * thread, as do dump() and a crash signal; dumps are Chrome traces in logs/ that open in Perfetto.
+ *
+ * The crash dump is written from the signal handler using only async-signal-safe calls, into a buffer allocated at
+ * startup, so a crash in the allocator or under a lock still ends the process.
+ */
+class FlightRecorder
+{
+public:
+    // @brief Starts recording, keeping the given number of seconds, and installs the crash signal handlers.
+    static void enable(float seconds, float hitchFactor);
+    static bool isEnabled();
+
+    // @brief Records a profiler scope. Called by the profiler on the main thread.
+    static void recordZone(const char* name, uint32_t thread, int64_t start, int64_t end);
+    // @brief Records a finished frame and checks it for a hitch. Call once per frame after Profiler::endFrame().
+    static void endFrame(float cpuMilliseconds, float gpuMilliseconds, const GlCounters::Counts& counts);
+
+    // @brief Writes the recording to logs/ in the background. Returns an error if a dump is still being written.
+    static std::optional<std::string> dump(const std::string& reason);
+    // @brief Waits for a dump being written. Call before exiting.
+    static void shutdown();
+
+    // @brief Returns the log sink that feeds log lines to the recorder.
+    static std::shared_ptr<spdlog::sinks::sink> getLogSink();
+};
+
+#endif //KUMIGAME_DEBUG_FLIGHT_RECORDER_HPP
@@ -0,0 +1,57 @@
+#include "frameTimeGraph.hpp"
+#include "memoryTracker.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+
+FrameTimeGraph::FrameTimeGraph(std::shared_ptr<Shader>& shader)
+    : shader(shader)
+{
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+    glBindVertexArray(0);
+}
+
+FrameTimeGraph::~FrameTimeGraph()
+{
+    MemoryTracker::releaseBuffer(vbo);
+    glDeleteBuffers(1, &vbo);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void FrameTimeGraph::render(const std::vector<float>& times, glm::vec2 origin, glm::vec2 size, float maxMilliseconds,
+                            glm::ivec2 windowSize, glm::vec4 color)
+{
+    if (times.size() < 2)
+    {
+        return;
+    }
+
+    // Orphan the previous storage so the driver does not wait for last frame's draw to finish reading it.
+    capacity = std::max(capacity, times.size());
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * sizeof(float)), nullptr, GL_STREAM_DRAW);
+    MemoryTracker::trackBuffer(vbo, MemoryCategory::General, capacity * sizeof(float));
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(times.size() * sizeof(float)), times.data());
+
+    shader->use();
+    shader->setMatrix4("Projection", glm::ortho(0.0f, static_cast<float>(windowSize.x),
+                                                static_cast<float>(windowSize.y), 0.0f));
+    shader->setVector2f("Origin", origin);
+    shader->setVector2f("Size", size);
+    shader->setFloat("MaxMilliseconds", maxMilliseconds);
+    shader->setInteger("Count", static_cast<GLint>(times.size()));
+    shader->setVector4f("Color", color);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(vao);
+    glDrawArrays(GL_LINE_STRIP, 0, static_cast<GLsizei>(times.size()));
+    glBindVertexArray(0);
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
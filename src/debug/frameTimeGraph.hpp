@@ -0,0 +1,33 @@
+#ifndef KUMIGAME_DEBUG_FRAME_TIME_GRAPH_HPP
+#define KUMIGAME_DEBUG_FRAME_TIME_GRAPH_HPP
+
+#include "../renderer/shader.hpp"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Draws a series of frame times as a line graph with a single line-strip draw.
+ */
+class FrameTimeGraph
+{
+public:
+    explicit FrameTimeGraph(std::shared_ptr<Shader>& shader);
+    ~FrameTimeGraph();
+
+    FrameTimeGraph(const FrameTimeGraph&) = delete;
+    FrameTimeGraph& operator=(const FrameTimeGraph&) = delete;
+
+    // @brief Draws the times, oldest on the left, scaled so maxMilliseconds reaches the top of the graph.
+    void render(const std::vector<float>& times, glm::vec2 origin, glm::vec2 size, float maxMilliseconds,
+                glm::ivec2 windowSize, glm::vec4 color);
+
+private:
+    std::shared_ptr<Shader> shader;
+    GLuint vao = 0;
+    GLuint vbo = 0;
+    size_t capacity = 0;
+};
+
+#endif //KUMIGAME_DEBUG_FRAME_TIME_GRAPH_HPP
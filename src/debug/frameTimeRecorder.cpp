@@ -0,0 +1,130 @@
+#include "frameTimeRecorder.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+FrameTimeRecorder::FrameTimeRecorder(size_t capacity)
+    : capacity(std::max<size_t>(capacity, 1))
+{
+    for (Series* series : { &cpu, &gpu })
+    {
+        series->ring.assign(this->capacity, 0.0f);
+        series->buckets.assign(bucketCount(), 0);
+    }
+}
+
+void FrameTimeRecorder::record(float cpuMilliseconds, float gpuMilliseconds)
+{
+    add(cpu, cpuMilliseconds);
+    add(gpu, gpuMilliseconds);
+    next = (next + 1) % capacity;
+    count = std::min(count + 1, capacity);
+}
+
+FrameTimeRecorder::Summary FrameTimeRecorder::getCpuSummary() const
+{
+    return summarize(cpu);
+}
+
+FrameTimeRecorder::Summary FrameTimeRecorder::getGpuSummary() const
+{
+    return summarize(gpu);
+}
+
+size_t FrameTimeRecorder::getCount() const
+{
+    return count;
+}
+
+void FrameTimeRecorder::getCpuTimes(std::vector<float>& times) const
+{
+    times.resize(count);
+    size_t oldest = (next + capacity - count) % capacity;
+    for (size_t i = 0; i < count; ++i)
+    {
+        times[i] = cpu.ring[(oldest + i) % capacity];
+    }
+}
+
+void FrameTimeRecorder::add(Series& series, float milliseconds)
+{
+    // The slot about to be overwritten holds the frame leaving the window.
+    if (count == capacity)
+    {
+        series.buckets[bucketIndex(static_cast<uint32_t>(series.ring[next] * 1000.0f))]--;
+    }
+
+    milliseconds = std::clamp(milliseconds, 0.0f, static_cast<float>(MAX_MICROSECONDS) / 1000.0f);
+    series.ring[next] = milliseconds;
+    series.buckets[bucketIndex(static_cast<uint32_t>(milliseconds * 1000.0f))]++;
+}
+
+FrameTimeRecorder::Summary FrameTimeRecorder::summarize(const Series& series) const
+{
+    Summary summary;
+    if (count == 0)
+    {
+        return summary;
+    }
+
+    const float percentiles[] = { 0.5f, 0.95f, 0.99f, 0.999f };
+    float* results[] = { &summary.p50, &summary.p95, &summary.p99, &summary.p999 };
+    size_t percentile = 0;
+    size_t seen = 0;
+    for (size_t i = 0; i < series.buckets.size() && percentile < std::size(percentiles); ++i)
+    {
+        seen += series.buckets[i];
+        // Report the middle of the bucket the percentile falls into.
+        while (percentile < std::size(percentiles) &&
+               static_cast<float>(seen) >= std::ceil(percentiles[percentile] * static_cast<float>(count)))
+        {
+            float lower = static_cast<float>(bucketLowerBound(i));
+            float upper = static_cast<float>(bucketLowerBound(i + 1));
+            *results[percentile] = 0.5f * (lower + upper) / 1000.0f;
+            percentile++;
+        }
+    }
+
+    // The maximum is exact, the window is small enough to scan.
+    size_t oldest = (next + capacity - count) % capacity;
+    for (size_t i = 0; i < count; ++i)
+    {
+        summary.max = std::max(summary.max, series.ring[(oldest + i) % capacity]);
+    }
+
+    return summary;
+}
+
+size_t FrameTimeRecorder::bucketIndex(uint32_t microseconds)
+{
+    const uint32_t subBuckets = 1u << SUB_BUCKET_BITS;
+    const uint32_t halfSubBuckets = subBuckets / 2;
+    microseconds = std::min(microseconds, MAX_MICROSECONDS);
+    if (microseconds < subBuckets)
+    {
+        return microseconds;
+    }
+
+    // Shift so the value falls in [halfSubBuckets, subBuckets); each shift is one power of two.
+    auto shift = static_cast<unsigned int>(std::bit_width(microseconds)) - SUB_BUCKET_BITS;
+    return subBuckets + (shift - 1) * halfSubBuckets + ((microseconds >> shift) - halfSubBuckets);
+}
+
+uint32_t FrameTimeRecorder::bucketLowerBound(size_t index)
+{
+    const uint32_t subBuckets = 1u << SUB_BUCKET_BITS;
+    const uint32_t halfSubBuckets = subBuckets / 2;
+    if (index < subBuckets)
+    {
+        return static_cast<uint32_t>(index);
+    }
+
+    auto offset = static_cast<uint32_t>(index - subBuckets);
+    uint32_t shift = offset / halfSubBuckets + 1;
+    return (halfSubBuckets + offset % halfSubBuckets) << shift;
+}
+
+size_t FrameTimeRecorder::bucketCount()
+{
+    return bucketIndex(MAX_MICROSECONDS) + 1;
+}
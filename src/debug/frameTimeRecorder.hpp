@@ -0,0 +1,64 @@
+#ifndef KUMIGAME_DEBUG_FRAME_TIME_RECORDER_HPP
+#define KUMIGAME_DEBUG_FRAME_TIME_RECORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Keeps the CPU and GPU time of the most recent frames and their distribution.
+ *
+ * Times are kept in a fixed-size ring and counted in a log-linear histogram, in the style of HdrHistogram: buckets
+ * are linear within each power of two, so every bucket is within about 3% of the values it holds whatever the scale.
+ * A frame leaving the ring is removed from the histogram again, so percentiles always describe the rolling window.
+ */
+class FrameTimeRecorder
+{
+public:
+    struct Summary
+    {
+        float p50 = 0.0f;
+        float p95 = 0.0f;
+        float p99 = 0.0f;
+        float p999 = 0.0f;
+        float max = 0.0f;
+    };
+
+    explicit FrameTimeRecorder(size_t capacity = 1024);
+
+    void record(float cpuMilliseconds, float gpuMilliseconds);
+
+    Summary getCpuSummary() const;
+    Summary getGpuSummary() const;
+    // @brief Returns the number of frames in the window.
+    size_t getCount() const;
+    // @brief Copies the CPU times in the window into times, oldest first.
+    void getCpuTimes(std::vector<float>& times) const;
+
+private:
+    // Values below 2^SUB_BUCKET_BITS microseconds get a bucket each; above, every power of two is split into
+    // 2^(SUB_BUCKET_BITS - 1) buckets.
+    static constexpr unsigned int SUB_BUCKET_BITS = 6;
+    static constexpr uint32_t MAX_MICROSECONDS = 60'000'000;
+
+    struct Series
+    {
+        std::vector<float> ring;
+        std::vector<uint32_t> buckets;
+    };
+
+    size_t capacity;
+    size_t next = 0;
+    size_t count = 0;
+    Series cpu;
+    Series gpu;
+
+    void add(Series& series, float milliseconds);
+    Summary summarize(const Series& series) const;
+
+    static size_t bucketIndex(uint32_t microseconds);
+    static uint32_t bucketLowerBound(size_t index);
+    static size_t bucketCount();
+};
+
+#endif //KUMIGAME_DEBUG_FRAME_TIME_RECORDER_HPP
@@ -0,0 +1,367 @@
+#include "glCounters.hpp"
+#include <glad/glad.h>
+
+namespace
+{
+    GlCounters::Counts current;
+    GlCounters::Counts frame;
+}
+
+#ifdef KUMIGAME_GL_COUNTERS
+
+namespace
+{
+    uint64_t primitiveCount(GLenum mode, GLsizei count)
+    {
+        if (count <= 0)
+        {
+            return 0;
+        }
+
+        auto vertices = static_cast<uint64_t>(count);
+        switch (mode)
+        {
+            case GL_POINTS:
+            case GL_LINE_LOOP:
+                return vertices;
+            case GL_LINES:
+                return vertices / 2;
+            case GL_LINE_STRIP:
+                return vertices - 1;
+            case GL_TRIANGLES:
+                return vertices / 3;
+            case GL_TRIANGLE_STRIP:
+            case GL_TRIANGLE_FAN:
+                return vertices < 2 ? 0 : vertices - 2;
+            default:
+                return 0;
+        }
+    }
+
+    uint64_t pixelSize(GLenum format, GLenum type)
+    {
+        // Packed types hold a whole pixel.
+        switch (type)
+        {
+            case GL_UNSIGNED_INT_24_8:
+            case GL_UNSIGNED_INT_8_8_8_8:
+            case GL_UNSIGNED_INT_8_8_8_8_REV:
+            case GL_UNSIGNED_INT_2_10_10_10_REV:
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+                return 4;
+            case GL_UNSIGNED_SHORT_5_6_5:
+            case GL_UNSIGNED_SHORT_4_4_4_4:
+            case GL_UNSIGNED_SHORT_5_5_5_1:
+                return 2;
+            default:
+                break;
+        }
+
+        uint64_t components = 1;
+        switch (format)
+        {
+            case GL_RG:
+            case GL_RG_INTEGER:
+                components = 2;
+                break;
+            case GL_RGB:
+            case GL_BGR:
+            case GL_RGB_INTEGER:
+                components = 3;
+                break;
+            case GL_RGBA:
+            case GL_BGRA:
+            case GL_RGBA_INTEGER:
+                components = 4;
+                break;
+            default:
+                break;
+        }
+
+        switch (type)
+        {
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+            case GL_HALF_FLOAT:
+                return components * 2;
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_FLOAT:
+                return components * 4;
+            default:
+                return components;
+        }
+    }
+
+    uint64_t imageSize(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type)
+    {
+        if (width <= 0 || height <= 0 || depth <= 0)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(depth) *
+               pixelSize(format, type);
+    }
+
+    // Draws
+
+    PFNGLDRAWARRAYSPROC real_glDrawArrays;
+    void APIENTRY counted_glDrawArrays(GLenum mode, GLint first, GLsizei count)
+    {
+        current.drawCalls++;
+        current.primitives += primitiveCount(mode, count);
+        real_glDrawArrays(mode, first, count);
+    }
+
+    PFNGLDRAWELEMENTSPROC real_glDrawElements;
+    void APIENTRY counted_glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        current.drawCalls++;
+        current.primitives += primitiveCount(mode, count);
+        real_glDrawElements(mode, count, type, indices);
+    }
+
+    PFNGLDRAWARRAYSINSTANCEDPROC real_glDrawArraysInstanced;
+    void APIENTRY counted_glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+    {
+        current.drawCalls++;
+        current.primitives += primitiveCount(mode, count) * static_cast<uint64_t>(instances);
+        real_glDrawArraysInstanced(mode, first, count, instances);
+    }
+
+    PFNGLDRAWELEMENTSINSTANCEDPROC real_glDrawElementsInstanced;
+    void APIENTRY counted_glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+                                                  GLsizei instances)
+    {
+        current.drawCalls++;
+        current.primitives += primitiveCount(mode, count) * static_cast<uint64_t>(instances);
+        real_glDrawElementsInstanced(mode, count, type, indices, instances);
+    }
+
+    PFNGLMULTIDRAWARRAYSINDIRECTPROC real_glMultiDrawArraysIndirect;
+    void APIENTRY counted_glMultiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawCount,
+                                                    GLsizei stride)
+    {
+        current.drawCalls++;
+        real_glMultiDrawArraysIndirect(mode, indirect, drawCount, stride);
+    }
+
+    PFNGLDISPATCHCOMPUTEPROC real_glDispatchCompute;
+    void APIENTRY counted_glDispatchCompute(GLuint x, GLuint y, GLuint z)
+    {
+        current.dispatches++;
+        real_glDispatchCompute(x, y, z);
+    }
+
+    // Binds
+
+    PFNGLUSEPROGRAMPROC real_glUseProgram;
+    void APIENTRY counted_glUseProgram(GLuint program)
+    {
+        current.programBinds++;
+        real_glUseProgram(program);
+    }
+
+    PFNGLBINDVERTEXARRAYPROC real_glBindVertexArray;
+    void APIENTRY counted_glBindVertexArray(GLuint array)
+    {
+        current.vertexArrayBinds++;
+        real_glBindVertexArray(array);
+    }
+
+    PFNGLBINDTEXTUREPROC real_glBindTexture;
+    void APIENTRY counted_glBindTexture(GLenum target, GLuint texture)
+    {
+        current.textureBinds++;
+        real_glBindTexture(target, texture);
+    }
+
+    PFNGLBINDIMAGETEXTUREPROC real_glBindImageTexture;
+    void APIENTRY counted_glBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer,
+                                             GLenum access, GLenum format)
+    {
+        current.textureBinds++;
+        real_glBindImageTexture(unit, texture, level, layered, layer, access, format);
+    }
+
+    // Uniforms
+
+    PFNGLUNIFORM1FPROC real_glUniform1f;
+    void APIENTRY counted_glUniform1f(GLint location, GLfloat v0)
+    {
+        current.uniformUploads++;
+        real_glUniform1f(location, v0);
+    }
+
+    PFNGLUNIFORM2FPROC real_glUniform2f;
+    void APIENTRY counted_glUniform2f(GLint location, GLfloat v0, GLfloat v1)
+    {
+        current.uniformUploads++;
+        real_glUniform2f(location, v0, v1);
+    }
+
+    PFNGLUNIFORM3FPROC real_glUniform3f;
+    void APIENTRY counted_glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+    {
+        current.uniformUploads++;
+        real_glUniform3f(location, v0, v1, v2);
+    }
+
+    PFNGLUNIFORM4FPROC real_glUniform4f;
+    void APIENTRY counted_glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+    {
+        current.uniformUploads++;
+        real_glUniform4f(location, v0, v1, v2, v3);
+    }
+
+    PFNGLUNIFORM1IPROC real_glUniform1i;
+    void APIENTRY counted_glUniform1i(GLint location, GLint v0)
+    {
+        current.uniformUploads++;
+        real_glUniform1i(location, v0);
+    }
+
+    PFNGLUNIFORM2IPROC real_glUniform2i;
+    void APIENTRY counted_glUniform2i(GLint location, GLint v0, GLint v1)
+    {
+        current.uniformUploads++;
+        real_glUniform2i(location, v0, v1);
+    }
+
+    PFNGLUNIFORM1FVPROC real_glUniform1fv;
+    void APIENTRY counted_glUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+    {
+        current.uniformUploads++;
+        real_glUniform1fv(location, count, value);
+    }
+
+    PFNGLUNIFORM2FVPROC real_glUniform2fv;
+    void APIENTRY counted_glUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+    {
+        current.uniformUploads++;
+        real_glUniform2fv(location, count, value);
+    }
+
+    PFNGLUNIFORMMATRIX3FVPROC real_glUniformMatrix3fv;
+    void APIENTRY counted_glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+    {
+        current.uniformUploads++;
+        real_glUniformMatrix3fv(location, count, transpose, value);
+    }
+
+    PFNGLUNIFORMMATRIX4FVPROC real_glUniformMatrix4fv;
+    void APIENTRY counted_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+    {
+        current.uniformUploads++;
+        real_glUniformMatrix4fv(location, count, transpose, value);
+    }
+
+    // Uploads
+
+    PFNGLBUFFERDATAPROC real_glBufferData;
+    void APIENTRY counted_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+    {
+        // Allocating storage without data uploads nothing.
+        if (data && size > 0)
+        {
+            current.bufferBytes += static_cast<uint64_t>(size);
+        }
+        real_glBufferData(target, size, data, usage);
+    }
+
+    PFNGLBUFFERSUBDATAPROC real_glBufferSubData;
+    void APIENTRY counted_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        if (size > 0)
+        {
+            current.bufferBytes += static_cast<uint64_t>(size);
+        }
+        real_glBufferSubData(target, offset, size, data);
+    }
+
+    PFNGLTEXIMAGE2DPROC real_glTexImage2D;
+    void APIENTRY counted_glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+                                       GLint border, GLenum format, GLenum type, const void* pixels)
+    {
+        if (pixels)
+        {
+            current.textureBytes += imageSize(width, height, 1, format, type);
+        }
+        real_glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+    }
+
+    PFNGLTEXSUBIMAGE2DPROC real_glTexSubImage2D;
+    void APIENTRY counted_glTexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+                                          GLenum format, GLenum type, const void* pixels)
+    {
+        current.textureBytes += imageSize(width, height, 1, format, type);
+        real_glTexSubImage2D(target, level, x, y, width, height, format, type, pixels);
+    }
+
+    PFNGLTEXSUBIMAGE3DPROC real_glTexSubImage3D;
+    void APIENTRY counted_glTexSubImage3D(GLenum target, GLint level, GLint x, GLint y, GLint z, GLsizei width,
+                                          GLsizei height, GLsizei depth, GLenum format, GLenum type,
+                                          const void* pixels)
+    {
+        current.textureBytes += imageSize(width, height, depth, format, type);
+        real_glTexSubImage3D(target, level, x, y, z, width, height, depth, format, type, pixels);
+    }
+}
+
+// Keeps glad's pointer and puts the counting wrapper in its place.
+#define KUMIGAME_GL_WRAP(name) \
+    if (glad_##name && glad_##name != counted_##name) \
+    { \
+        real_##name = glad_##name; \
+        glad_##name = counted_##name; \
+    }
+
+void GlCounters::install()
+{
+    KUMIGAME_GL_WRAP(glDrawArrays)
+    KUMIGAME_GL_WRAP(glDrawElements)
+    KUMIGAME_GL_WRAP(glDrawArraysInstanced)
+    KUMIGAME_GL_WRAP(glDrawElementsInstanced)
+    KUMIGAME_GL_WRAP(glMultiDrawArraysIndirect)
+    KUMIGAME_GL_WRAP(glDispatchCompute)
+    KUMIGAME_GL_WRAP(glUseProgram)
+    KUMIGAME_GL_WRAP(glBindVertexArray)
+    KUMIGAME_GL_WRAP(glBindTexture)
+    KUMIGAME_GL_WRAP(glBindImageTexture)
+    KUMIGAME_GL_WRAP(glUniform1f)
+    KUMIGAME_GL_WRAP(glUniform2f)
+    KUMIGAME_GL_WRAP(glUniform3f)
+    KUMIGAME_GL_WRAP(glUniform4f)
+    KUMIGAME_GL_WRAP(glUniform1i)
+    KUMIGAME_GL_WRAP(glUniform2i)
+    KUMIGAME_GL_WRAP(glUniform1fv)
+    KUMIGAME_GL_WRAP(glUniform2fv)
+    KUMIGAME_GL_WRAP(glUniformMatrix3fv)
+    KUMIGAME_GL_WRAP(glUniformMatrix4fv)
+    KUMIGAME_GL_WRAP(glBufferData)
+    KUMIGAME_GL_WRAP(glBufferSubData)
+    KUMIGAME_GL_WRAP(glTexImage2D)
+    KUMIGAME_GL_WRAP(glTexSubImage2D)
+    KUMIGAME_GL_WRAP(glTexSubImage3D)
+}
+
+#undef KUMIGAME_GL_WRAP
+
+#else
+
+void GlCounters::install()
+{
+}
+
+#endif
+
+void GlCounters::endFrame()
+{
+    frame = current;
+    current = {};
+}
+
+const GlCounters::Counts& GlCounters::getFrame()
+{
+    return frame;
+}
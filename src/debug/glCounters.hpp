@@ -0,0 +1,45 @@
+#ifndef KUMIGAME_DEBUG_GL_COUNTERS_HPP
+#define KUMIGAME_DEBUG_GL_COUNTERS_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Counts the GL calls the renderer makes each frame.
+ *
+ * Only compiled in when building with the KUMIGAME_GL_COUNTERS option. install() then replaces glad's function
+ * pointers with wrappers that count the call and forward it, so every GL call in the game is counted without changing
+ * the call sites. Without the option every count stays zero and the calls go straight to the driver.
+ *
+ * Primitives of indirect draws are not counted, since their counts live in a GPU buffer.
+ */
+class GlCounters
+{
+public:
+    struct Counts
+    {
+        uint64_t drawCalls = 0;
+        uint64_t dispatches = 0;
+        uint64_t primitives = 0;
+        uint64_t programBinds = 0;
+        uint64_t vertexArrayBinds = 0;
+        uint64_t textureBinds = 0;
+        uint64_t uniformUploads = 0;
+        uint64_t bufferBytes = 0;
+        uint64_t textureBytes = 0;
+    };
+
+#ifdef KUMIGAME_GL_COUNTERS
+    static constexpr bool ENABLED = true;
+#else
+    static constexpr bool ENABLED = false;
+#endif
+
+    // @brief Wraps the GL functions. Call once after glad has loaded them.
+    static void install();
+    // @brief Makes the counts of the frame that just ended available and starts counting the next one.
+    static void endFrame();
+    // @brief Returns the counts of the last finished frame.
+    static const Counts& getFrame();
+};
+
+#endif //KUMIGAME_DEBUG_GL_COUNTERS_HPP
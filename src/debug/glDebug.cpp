@@ -1,137 +1,285 @@
 #include "glDebug.hpp"
 #include "log.hpp"
+#include "../util/clock.hpp"
+#include "../util/mpscQueue.hpp"
 #include <glad/glad.h>
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <unordered_map>
 
-void APIENTRY glDebugOutput(GLenum source, GLenum type, GLuint id, GLenum severity,
-                            GLsizei length, const GLchar* message, const void* userParam)
+namespace
 {
-    // Ignore non-significant error/warning codes.
-    if (id == 131169 || id == 131185 || id == 131218 || id == 131204)
+    const size_t QUEUE_CAPACITY = 256;
+    const size_t MESSAGE_SIZE = 500;
+    // Messages logged per ID and second; the rest are counted and summarized.
+    const unsigned int MESSAGES_PER_SECOND = 3;
+
+    struct Message
     {
-        return;
-    }
+        GLenum source;
+        GLenum type;
+        GLenum severity;
+        GLuint id;
+        size_t length;
+        char text[MESSAGE_SIZE];
+    };
 
-    std::stringstream output;
-    output << "OpenGL: " << message;
+    struct Statistics
+    {
+        uint64_t count = 0;
+        GLenum severity = GL_DONT_CARE;
+        double windowStart = 0.0;
+        unsigned int logged = 0;
+        uint64_t suppressed = 0;
+    };
+
+    MpscQueue<Message, QUEUE_CAPACITY> queue;
+    std::atomic<uint64_t> dropped = 0;
+    std::atomic<bool> synchronous = false;
+    bool installed = false;
+    std::thread::id mainThread;
 
-    output << "\n\tID: " << id;
+    // Main thread only.
+    std::unordered_map<GLuint, Statistics> statistics;
+    double lastSummary = 0.0;
 
-    output << "\n\tSource: ";
-    switch (source)
+    const char* sourceName(GLenum source)
     {
-        case GL_DEBUG_SOURCE_API:
-        {
-            output << "API";
-            break;
-        }
-        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
-        {
-            output << "Window System";
-            break;
-        }
-        case GL_DEBUG_SOURCE_SHADER_COMPILER:
-        {
-            output << "Shader Compiler";
-            break;
-        }
-        case GL_DEBUG_SOURCE_THIRD_PARTY:
+        switch (source)
         {
-            output << "Third Party";
-            break;
+            case GL_DEBUG_SOURCE_API:
+                return "API";
+            case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+                return "Window System";
+            case GL_DEBUG_SOURCE_SHADER_COMPILER:
+                return "Shader Compiler";
+            case GL_DEBUG_SOURCE_THIRD_PARTY:
+                return "Third Party";
+            case GL_DEBUG_SOURCE_APPLICATION:
+                return "Application";
+            default:
+                return "Other";
         }
-        case GL_DEBUG_SOURCE_APPLICATION:
-        {
-            output << "Application";
-            break;
-        }
-        case GL_DEBUG_SOURCE_OTHER:
-        {
-            output << "Other";
-            break;
-        }
-        default:
-            break;
     }
 
-    output << "\n\tType: ";
-    switch (type)
+    const char* typeName(GLenum type)
     {
-        case GL_DEBUG_TYPE_ERROR:
-        {
-            output << "Error";
-            break;
-        }
-        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
-        {
-            output << "Deprecated Behavior";
-            break;
-        }
-        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
-        {
-            output << "Undefined Behavior";
-            break;
-        }
-        case GL_DEBUG_TYPE_PORTABILITY:
+        switch (type)
         {
-            output << "Portability";
-            break;
+            case GL_DEBUG_TYPE_ERROR:
+                return "Error";
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+                return "Deprecated Behavior";
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+                return "Undefined Behavior";
+            case GL_DEBUG_TYPE_PORTABILITY:
+                return "Portability";
+            case GL_DEBUG_TYPE_PERFORMANCE:
+                return "Performance";
+            case GL_DEBUG_TYPE_MARKER:
+                return "Marker";
+            case GL_DEBUG_TYPE_PUSH_GROUP:
+                return "Push Group";
+            case GL_DEBUG_TYPE_POP_GROUP:
+                return "Pop Group";
+            default:
+                return "Other";
         }
-        case GL_DEBUG_TYPE_PERFORMANCE:
+    }
+
+    const char* severityName(GLenum severity)
+    {
+        switch (severity)
         {
-            output << "Performance";
-            break;
+            case GL_DEBUG_SEVERITY_HIGH:
+                return "High";
+            case GL_DEBUG_SEVERITY_MEDIUM:
+                return "Medium";
+            case GL_DEBUG_SEVERITY_LOW:
+                return "Low";
+            case GL_DEBUG_SEVERITY_NOTIFICATION:
+                return "Notification";
+            default:
+                return "Unknown";
         }
-        case GL_DEBUG_TYPE_MARKER:
+    }
+
+    spdlog::level::level_enum severityLevel(GLenum severity)
+    {
+        switch (severity)
         {
-            output << "Marker";
-            break;
+            case GL_DEBUG_SEVERITY_HIGH:
+                return spdlog::level::err;
+            case GL_DEBUG_SEVERITY_MEDIUM:
+                return spdlog::level::warn;
+            case GL_DEBUG_SEVERITY_LOW:
+                return spdlog::level::info;
+            default:
+                return spdlog::level::debug;
         }
-        case GL_DEBUG_TYPE_PUSH_GROUP:
+    }
+
+    void summarize(GLuint id, Statistics& stats, double now)
+    {
+        if (stats.suppressed > 0)
         {
-            output << "Push Group";
-            break;
+            gameLogger->log(severityLevel(stats.severity), "OpenGL message {} repeated {} more times in {:.1f} s.", id,
+                            stats.suppressed, now - stats.windowStart);
         }
-        case GL_DEBUG_TYPE_POP_GROUP:
+        stats.windowStart = now;
+        stats.logged = 0;
+        stats.suppressed = 0;
+    }
+
+    // Main thread only.
+    void report(const Message& message, double now)
+    {
+        Statistics& stats = statistics[message.id];
+        stats.count++;
+        stats.severity = message.severity;
+        if (now - stats.windowStart >= 1.0)
         {
-            output << "Pop Group";
-            break;
+            summarize(message.id, stats, now);
         }
-        case GL_DEBUG_TYPE_OTHER:
+        if (stats.logged >= MESSAGES_PER_SECOND)
         {
-            output << "Other";
-            break;
+            stats.suppressed++;
+            return;
         }
-        default:
-            break;
+
+        stats.logged++;
+        gameLogger->log(severityLevel(message.severity), "OpenGL {} from {} ({}, ID {}): {}", typeName(message.type),
+                        sourceName(message.source), severityName(message.severity), message.id,
+                        std::string(message.text, message.length));
     }
 
-    output << "\n\tSeverity: ";
-    switch (severity)
+    void APIENTRY onMessage(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                            const GLchar* text, const void*)
     {
-        case GL_DEBUG_SEVERITY_HIGH:
+        // Ignore non-significant error/warning codes.
+        if (id == 131169 || id == 131185 || id == 131218 || id == 131204)
         {
-            output << "High";
-            break;
+            return;
         }
-        case GL_DEBUG_SEVERITY_MEDIUM:
+
+        Message message;
+        message.source = source;
+        message.type = type;
+        message.severity = severity;
+        message.id = id;
+        message.length = std::min(static_cast<size_t>(length >= 0 ? length : std::strlen(text)), MESSAGE_SIZE);
+        std::memcpy(message.text, text, message.length);
+
+        if (!queue.tryPush(message))
         {
-            output << "Medium";
-            break;
+            dropped.fetch_add(1, std::memory_order_relaxed);
         }
-        case GL_DEBUG_SEVERITY_LOW:
+
+        // Synchronous messages arrive inside the GL call that caused them, which is made by the main thread, and are
+        // logged there and then. Driver threads may still call in, so only the main thread drains.
+        if (synchronous.load(std::memory_order_relaxed) && std::this_thread::get_id() == mainThread)
         {
-            output << "Low";
-            break;
+            GlDebug::drain();
         }
-        case GL_DEBUG_SEVERITY_NOTIFICATION:
+    }
+}
+
+void GlDebug::install(bool synchronous)
+{
+    GLint flags;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT))
+    {
+        return;
+    }
+
+    mainThread = std::this_thread::get_id();
+    glEnable(GL_DEBUG_OUTPUT);
+    glDebugMessageCallback(onMessage, nullptr);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
+    installed = true;
+    setSynchronous(synchronous);
+}
+
+void GlDebug::setSynchronous(bool enabled)
+{
+    if (!installed)
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    else
+    {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    // Messages queued before the switch are still logged by the next drain.
+    synchronous.store(enabled, std::memory_order_relaxed);
+}
+
+bool GlDebug::isSynchronous()
+{
+    return synchronous.load(std::memory_order_relaxed);
+}
+
+void GlDebug::drain()
+{
+    if (!installed)
+    {
+        return;
+    }
+
+    double now = nowSeconds();
+    Message message;
+    while (queue.tryPop(message))
+    {
+        report(message, now);
+    }
+
+    uint64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+    if (lost > 0)
+    {
+        LOG_WARN("Dropped {} OpenGL messages because the queue was full.", lost);
+    }
+
+    // Summarize IDs that went quiet after being rate limited.
+    if (now - lastSummary >= 1.0)
+    {
+        lastSummary = now;
+        for (auto& [id, stats] : statistics)
         {
-            output << "Notification";
-            break;
+            if (stats.suppressed > 0 && now - stats.windowStart >= 1.0)
+            {
+                summarize(id, stats, now);
+            }
         }
-        default:
-            break;
+    }
+}
+
+std::string GlDebug::getReport()
+{
+    if (!installed)
+    {
+        return "Not a debug context; no OpenGL messages are reported.";
     }
 
-    LOG_WARN(output.str());
+    std::map<GLuint, const Statistics*> sorted;
+    for (const auto& [id, stats] : statistics)
+    {
+        sorted[id] = &stats;
+    }
+
+    std::string report = fmt::format("{:<12}{:<14}{:>10}  ({})", "ID", "Severity", "Count",
+                                     isSynchronous() ? "synchronous" : "asynchronous");
+    for (const auto& [id, stats] : sorted)
+    {
+        report += fmt::format("\n{:<12}{:<14}{:>10}", id, severityName(stats->severity), stats->count);
+    }
+    return report;
 }
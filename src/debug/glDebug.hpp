@@ -2,8 +2,28 @@
 #define KUMIGAME_DEBUG_GL_DEBUG_HPP
 
 #include <glad/glad.h>
+#include <string>
 
-void APIENTRY glDebugOutput(GLenum source, GLenum type, GLuint id, GLenum severity,
-                            GLsizei length, const GLchar* message, const void* userParam);
+/**
+ * @brief Logs the messages of a GL debug context without slowing the renderer down.
+ *
+ * By default the driver reports messages asynchronously, possibly from its own threads, and the callback only copies
+ * each message into a lock-free queue that the main thread drains once per frame. Messages are counted by ID; each ID
+ * logs at most a few messages per second and the rest are summarized. Synchronous mode drains the queue inside the GL
+ * call that caused a message, so a breakpoint in the callback shows the call site, at a large cost in frame time.
+ */
+class GlDebug
+{
+public:
+    // @brief Enables debug output if the context is a debug context.
+    static void install(bool synchronous = false);
+    static void setSynchronous(bool synchronous);
+    static bool isSynchronous();
+
+    // @brief Logs the messages queued since the last call. Call once per frame on the main thread.
+    static void drain();
+    // @brief Returns a table of how often each message ID was reported, one line per ID.
+    static std::string getReport();
+};
 
 #endif //KUMIGAME_DEBUG_GL_DEBUG_HPP
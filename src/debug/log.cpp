@@ -1,17 +1,33 @@
 #include "log.hpp"
+#include "flightRecorder.hpp"
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <memory>
+#include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #ifndef NDEBUG
 #include <spdlog/sinks/msvc_sink.h>
 #endif
 
+std::shared_ptr<spdlog::logger> gameLogger;
+
+namespace
+{
+    // Messages waiting for the logging thread. When it falls this far behind, the oldest are dropped.
+    const size_t LOG_QUEUE_SIZE = 8192;
+    // Finished messages are written out at least this often.
+    const std::chrono::seconds LOG_FLUSH_INTERVAL(1);
+}
+
 std::string createLogFiles(std::vector<std::string>& errors, unsigned short int keepNumLogs);
+spdlog::level::level_enum getLoggerLevel(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel);
 void createLogger(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel, const char* filename);
 
 void initLog(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel, unsigned short int keepNumLogs)
@@ -34,8 +50,32 @@ void initLog(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum f
 
 void changeLogLevels(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel)
 {
-    spdlog::drop("logger");
-    createLogger(consoleLevel, fileLevel, "logs/game.0.log");
+    // The sinks are changed in place, so the log file is kept and messages still queued are written.
+    gameLogger->sinks()[0]->set_level(consoleLevel);
+    gameLogger->sinks()[1]->set_level(fileLevel);
+    gameLogger->set_level(getLoggerLevel(consoleLevel, fileLevel));
+}
+
+void setLogger(std::shared_ptr<spdlog::logger> logger)
+{
+    spdlog::drop(logger->name());
+    spdlog::register_logger(logger);
+    gameLogger = std::move(logger);
+}
+
+void shutdownLog()
+{
+    if (!gameLogger)
+    {
+        return;
+    }
+
+    // Anything logged afterwards, e.g. by destructors, is written synchronously to the same sinks.
+    std::vector<spdlog::sink_ptr> sinks = gameLogger->sinks();
+    spdlog::level::level_enum level = gameLogger->level();
+    spdlog::shutdown();
+    gameLogger = std::make_shared<spdlog::logger>("logger", sinks.begin(), sinks.end());
+    gameLogger->set_level(level);
 }
 
 std::string createLogFiles(std::vector<std::string>& errors, unsigned short int keepNumLogs)
@@ -63,6 +103,16 @@ std::string createLogFiles(std::vector<std::string>& errors, unsigned short int
     return fileName;
 }
 
+// The lowest level any sink writes, so messages no sink would write are never formatted.
+spdlog::level::level_enum getLoggerLevel(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel)
+{
+#ifndef NDEBUG
+    return std::min({ consoleLevel, fileLevel, LOG_LEVEL_DEBUG });
+#else
+    return std::min(consoleLevel, fileLevel);
+#endif
+}
+
 void createLogger(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel, const char* filename)
 {
     // Create console log sink.
@@ -85,7 +135,16 @@ void createLogger(spdlog::level::level_enum consoleLevel, spdlog::level::level_e
     std::vector<spdlog::sink_ptr> sinks;
     sinks.push_back(consoleSink);
     sinks.push_back(fileSink);
-    auto logger = std::make_shared<spdlog::logger>("logger", sinks.begin(), sinks.end());
-    logger->set_level(spdlog::level::debug);
-    spdlog::register_logger(logger);
+    // Keeps the last log lines for flight recorder dumps.
+    sinks.push_back(FlightRecorder::getLogSink());
+
+    // Messages are formatted by the caller and written by a background thread, so a slow disk or terminal does not
+    // stall the frame. A full queue drops its oldest message instead of blocking.
+    spdlog::init_thread_pool(LOG_QUEUE_SIZE, 1);
+    auto logger = std::make_shared<spdlog::async_logger>("logger", sinks.begin(), sinks.end(), spdlog::thread_pool(),
+                                                         spdlog::async_overflow_policy::overrun_oldest);
+    logger->set_level(getLoggerLevel(consoleLevel, fileLevel));
+    logger->flush_on(spdlog::level::err);
+    setLogger(logger);
+    spdlog::flush_every(LOG_FLUSH_INTERVAL);
 }
@@ -2,13 +2,54 @@
 #define KUMIGAME_DEBUG_LOG_HPP
 
 #include <spdlog/spdlog.h>
+#include <memory>
 
-#define LOG_TRACE(msg, ...) spdlog::get("logger")->trace(msg, ##__VA_ARGS__)
-#define LOG_DEBUG(msg, ...) spdlog::get("logger")->debug(msg, ##__VA_ARGS__)
-#define LOG_INFO(msg, ...) spdlog::get("logger")->info(msg, ##__VA_ARGS__)
-#define LOG_WARN(msg, ...) spdlog::get("logger")->warn(msg, ##__VA_ARGS__)
-#define LOG_ERROR(msg, ...) spdlog::get("logger")->error(msg, ##__VA_ARGS__)
-#define LOG_CRITICAL(msg, ...) spdlog::get("logger")->critical(msg, ##__VA_ARGS__)
+// Messages below this level are compiled out, arguments included: 0 trace, 1 debug, 2 info, 3 warn, 4 error,
+// 5 critical, 6 off. Set with the KUMIGAME_LOG_LEVEL CMake cache variable.
+#ifndef KUMIGAME_LOG_LEVEL
+#ifdef NDEBUG
+#define KUMIGAME_LOG_LEVEL 2
+#else
+#define KUMIGAME_LOG_LEVEL 0
+#endif
+#endif
+
+// The logger, cached so that logging needs no lookup in spdlog's registry.
+extern std::shared_ptr<spdlog::logger> gameLogger;
+
+// A compiled out message is never evaluated or formatted. Its arguments still count as used, and are still checked.
+#define LOG_DISABLED(level, msg, ...) do { if (false) { gameLogger->level(msg, ##__VA_ARGS__); } } while (false)
+
+#if KUMIGAME_LOG_LEVEL <= 0
+#define LOG_TRACE(msg, ...) gameLogger->trace(msg, ##__VA_ARGS__)
+#else
+#define LOG_TRACE(msg, ...) LOG_DISABLED(trace, msg, ##__VA_ARGS__)
+#endif
+#if KUMIGAME_LOG_LEVEL <= 1
+#define LOG_DEBUG(msg, ...) gameLogger->debug(msg, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(msg, ...) LOG_DISABLED(debug, msg, ##__VA_ARGS__)
+#endif
+#if KUMIGAME_LOG_LEVEL <= 2
+#define LOG_INFO(msg, ...) gameLogger->info(msg, ##__VA_ARGS__)
+#else
+#define LOG_INFO(msg, ...) LOG_DISABLED(info, msg, ##__VA_ARGS__)
+#endif
+#if KUMIGAME_LOG_LEVEL <= 3
+#define LOG_WARN(msg, ...) gameLogger->warn(msg, ##__VA_ARGS__)
+#else
+#define LOG_WARN(msg, ...) LOG_DISABLED(warn, msg, ##__VA_ARGS__)
+#endif
+#if KUMIGAME_LOG_LEVEL <= 4
+#define LOG_ERROR(msg, ...) gameLogger->error(msg, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(msg, ...) LOG_DISABLED(error, msg, ##__VA_ARGS__)
+#endif
+#if KUMIGAME_LOG_LEVEL <= 5
+#define LOG_CRITICAL(msg, ...) gameLogger->critical(msg, ##__VA_ARGS__)
+#else
+#define LOG_CRITICAL(msg, ...) LOG_DISABLED(critical, msg, ##__VA_ARGS__)
+#endif
 
 #define LOG_LEVEL_TRACE spdlog::level::trace
 #define LOG_LEVEL_DEBUG spdlog::level::debug
@@ -23,4 +64,10 @@ void initLog(spdlog::level::level_enum consoleLevel = spdlog::level::warn,
 
 void changeLogLevels(spdlog::level::level_enum consoleLevel, spdlog::level::level_enum fileLevel);
 
+// @brief Logs through the given logger instead of the one initLog() creates, e.g. a null logger.
+void setLogger(std::shared_ptr<spdlog::logger> logger);
+
+// @brief Writes out queued messages and stops the logging thread. Call before exiting.
+void shutdownLog();
+
 #endif //KUMIGAME_DEBUG_LOG_HPP
@@ -0,0 +1,356 @@
+#include "memoryTracker.hpp"
+#include "log.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+namespace
+{
+    const size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::Count);
+
+    enum class ObjectKind : uint64_t
+    {
+        Buffer,
+        Texture,
+        Renderbuffer
+    };
+
+    struct Allocation
+    {
+        MemoryCategory category;
+        uint64_t bytes;
+    };
+
+    // GPU objects, keyed by their kind and name.
+    std::mutex gpuMutex;
+    std::unordered_map<uint64_t, Allocation> gpuAllocations;
+    std::array<uint64_t, CATEGORY_COUNT> gpuBytes{};
+    uint64_t gpuTotal = 0;
+    uint64_t vramBudget = 0;
+    bool overBudget = false;
+
+    // Heap allocations. Constant initialized, so they are usable by operator new before main().
+    thread_local MemoryCategory currentCategory = MemoryCategory::General;
+    std::atomic<int64_t> cpuBytes[CATEGORY_COUNT] = {};
+
+    // Stored in front of every heap allocation. Its size keeps the memory after it aligned for any type.
+    struct alignas(std::max_align_t) Header
+    {
+        uint64_t size;
+        MemoryCategory category;
+    };
+
+    uint64_t objectKey(ObjectKind kind, GLuint name)
+    {
+        return static_cast<uint64_t>(kind) << 32 | name;
+    }
+
+    void checkBudget()
+    {
+        if (vramBudget == 0 || gpuTotal <= vramBudget)
+        {
+            overBudget = false;
+            return;
+        }
+
+        // Warn once each time usage crosses the budget.
+        if (!overBudget)
+        {
+            overBudget = true;
+            size_t largest = 0;
+            for (size_t i = 1; i < CATEGORY_COUNT; ++i)
+            {
+                if (gpuBytes[i] > gpuBytes[largest])
+                {
+                    largest = i;
+                }
+            }
+            LOG_WARN("GPU memory budget of {:.1f} MB exceeded: {:.1f} MB in use, most of it by {} ({:.1f} MB).",
+                     static_cast<double>(vramBudget) / (1024.0 * 1024.0),
+                     static_cast<double>(gpuTotal) / (1024.0 * 1024.0),
+                     MemoryTracker::getCategoryName(static_cast<MemoryCategory>(largest)),
+                     static_cast<double>(gpuBytes[largest]) / (1024.0 * 1024.0));
+        }
+    }
+
+    void track(ObjectKind kind, GLuint name, MemoryCategory category, uint64_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(gpuMutex);
+        Allocation& allocation = gpuAllocations[objectKey(kind, name)];
+        gpuBytes[static_cast<size_t>(allocation.category)] -= allocation.bytes;
+        gpuTotal -= allocation.bytes;
+
+        allocation = { category, bytes };
+        gpuBytes[static_cast<size_t>(category)] += bytes;
+        gpuTotal += bytes;
+        checkBudget();
+    }
+
+    void release(ObjectKind kind, GLuint name)
+    {
+        std::lock_guard<std::mutex> lock(gpuMutex);
+        auto it = gpuAllocations.find(objectKey(kind, name));
+        if (it == gpuAllocations.end())
+        {
+            return;
+        }
+
+        gpuBytes[static_cast<size_t>(it->second.category)] -= it->second.bytes;
+        gpuTotal -= it->second.bytes;
+        gpuAllocations.erase(it);
+        checkBudget();
+    }
+
+    uint64_t pixelSize(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+            case GL_R8:
+            case GL_RED:
+            case GL_STENCIL_INDEX8:
+                return 1;
+            case GL_RG8:
+            case GL_R16F:
+            case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RG16F:
+            case GL_R32F:
+            case GL_RGBA8:
+            case GL_RGBA:
+            case GL_RGB10_A2:
+            case GL_R11F_G11F_B10F:
+            case GL_DEPTH24_STENCIL8:
+            case GL_DEPTH_COMPONENT24:
+            case GL_DEPTH_COMPONENT32F:
+            // Three channel formats are stored with a fourth channel by practically every GPU.
+            case GL_RGB8:
+            case GL_RGB:
+                return 4;
+            case GL_RG32F:
+            case GL_RGBA16F:
+            case GL_RGB16F:
+            case GL_DEPTH32F_STENCIL8:
+                return 8;
+            case GL_RGBA32F:
+            case GL_RGB32F:
+                return 16;
+            default:
+                return 4;
+        }
+    }
+
+    void* allocate(std::size_t size)
+    {
+        auto* header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+        if (!header)
+        {
+            return nullptr;
+        }
+
+        header->size = size;
+        header->category = currentCategory;
+        cpuBytes[static_cast<size_t>(header->category)].fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+        return header + 1;
+    }
+
+    void deallocate(void* pointer)
+    {
+        if (!pointer)
+        {
+            return;
+        }
+
+        Header* header = static_cast<Header*>(pointer) - 1;
+        cpuBytes[static_cast<size_t>(header->category)].fetch_sub(static_cast<int64_t>(header->size),
+                                                                   std::memory_order_relaxed);
+        std::free(header);
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    if (void* pointer = allocate(size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    if (void* pointer = allocate(size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+void MemoryTracker::trackBuffer(GLuint buffer, MemoryCategory category, uint64_t bytes)
+{
+    track(ObjectKind::Buffer, buffer, category, bytes);
+}
+
+void MemoryTracker::trackTexture(GLuint texture, MemoryCategory category, uint64_t bytes)
+{
+    track(ObjectKind::Texture, texture, category, bytes);
+}
+
+void MemoryTracker::trackRenderbuffer(GLuint renderbuffer, MemoryCategory category, uint64_t bytes)
+{
+    track(ObjectKind::Renderbuffer, renderbuffer, category, bytes);
+}
+
+void MemoryTracker::releaseBuffer(GLuint buffer)
+{
+    release(ObjectKind::Buffer, buffer);
+}
+
+void MemoryTracker::releaseTexture(GLuint texture)
+{
+    release(ObjectKind::Texture, texture);
+}
+
+void MemoryTracker::releaseRenderbuffer(GLuint renderbuffer)
+{
+    release(ObjectKind::Renderbuffer, renderbuffer);
+}
+
+uint64_t MemoryTracker::textureSize(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth,
+                                    GLsizei samples, bool mipmapped)
+{
+    if (width <= 0 || height <= 0 || depth <= 0)
+    {
+        return 0;
+    }
+
+    uint64_t bytes = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * static_cast<uint64_t>(depth) *
+                     static_cast<uint64_t>(samples > 0 ? samples : 1) * pixelSize(internalFormat);
+    // A full mipmap chain adds a third.
+    return mipmapped ? bytes * 4 / 3 : bytes;
+}
+
+void MemoryTracker::setVramBudget(uint64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(gpuMutex);
+    vramBudget = bytes;
+    overBudget = false;
+    checkBudget();
+}
+
+uint64_t MemoryTracker::getVramBudget()
+{
+    std::lock_guard<std::mutex> lock(gpuMutex);
+    return vramBudget;
+}
+
+MemoryTracker::Usage MemoryTracker::getUsage()
+{
+    Usage usage;
+    {
+        std::lock_guard<std::mutex> lock(gpuMutex);
+        usage.gpu = gpuBytes;
+        usage.gpuTotal = gpuTotal;
+    }
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        usage.cpu[i] = cpuBytes[i].load(std::memory_order_relaxed);
+        usage.cpuTotal += usage.cpu[i];
+    }
+    return usage;
+}
+
+std::string MemoryTracker::getReport()
+{
+    Usage usage = getUsage();
+    auto megabytes = [](auto bytes) {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    };
+
+    std::string report = fmt::format("{:<14}{:>12}{:>12}", "Category", "GPU (MB)", "Heap (MB)");
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i)
+    {
+        report += fmt::format("\n{:<14}{:>12.2f}{:>12.2f}", getCategoryName(static_cast<MemoryCategory>(i)),
+                              megabytes(usage.gpu[i]), megabytes(usage.cpu[i]));
+    }
+    report += fmt::format("\n{:<14}{:>12.2f}{:>12.2f}", "total", megabytes(usage.gpuTotal), megabytes(usage.cpuTotal));
+
+    uint64_t budget = getVramBudget();
+    if (budget > 0)
+    {
+        report += fmt::format("\nGPU budget: {:.0f} MB ({:.0f}% used)", megabytes(budget),
+                              100.0 * static_cast<double>(usage.gpuTotal) / static_cast<double>(budget));
+    }
+    return report;
+}
+
+const char* MemoryTracker::getCategoryName(MemoryCategory category)
+{
+    switch (category)
+    {
+        case MemoryCategory::General:
+            return "general";
+        case MemoryCategory::Mesh:
+            return "mesh";
+        case MemoryCategory::Texture:
+            return "texture";
+        case MemoryCategory::Font:
+            return "font";
+        case MemoryCategory::RenderTarget:
+            return "render target";
+        default:
+            return "unknown";
+    }
+}
+
+MemoryScope::MemoryScope(MemoryCategory category)
+    : previous(currentCategory)
+{
+    currentCategory = category;
+}
+
+MemoryScope::~MemoryScope()
+{
+    currentCategory = previous;
+}
@@ -0,0 +1,76 @@
+#ifndef KUMIGAME_DEBUG_MEMORY_TRACKER_HPP
+#define KUMIGAME_DEBUG_MEMORY_TRACKER_HPP
+
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+enum class MemoryCategory
+{
+    General,
+    Mesh,
+    Texture,
+    Font,
+    RenderTarget,
+    Count
+};
+
+/**
+ * @brief Accounts GPU and CPU memory by category.
+ *
+ * GPU memory is reported by the code creating buffers, textures and renderbuffers, since GL cannot tell how much
+ * memory an object uses. Sizes are estimates from the dimensions and format; the driver may pad them. Reporting an
+ * object again replaces its previous size.
+ *
+ * CPU memory is counted by the global operator new, which tags every allocation with the category of the innermost
+ * MemoryScope on the calling thread. Memory allocated with malloc, e.g. by stb_image, is not counted.
+ */
+class MemoryTracker
+{
+public:
+    struct Usage
+    {
+        std::array<uint64_t, static_cast<size_t>(MemoryCategory::Count)> gpu{};
+        std::array<int64_t, static_cast<size_t>(MemoryCategory::Count)> cpu{};
+        uint64_t gpuTotal = 0;
+        int64_t cpuTotal = 0;
+    };
+
+    static void trackBuffer(GLuint buffer, MemoryCategory category, uint64_t bytes);
+    static void trackTexture(GLuint texture, MemoryCategory category, uint64_t bytes);
+    static void trackRenderbuffer(GLuint renderbuffer, MemoryCategory category, uint64_t bytes);
+    static void releaseBuffer(GLuint buffer);
+    static void releaseTexture(GLuint texture);
+    static void releaseRenderbuffer(GLuint renderbuffer);
+
+    // @brief Estimates the size of a texture or renderbuffer, including its mipmap chain if it has one.
+    static uint64_t textureSize(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth = 1,
+                                GLsizei samples = 1, bool mipmapped = false);
+
+    // @brief Sets the GPU memory above which a warning is logged. Zero disables the warning.
+    static void setVramBudget(uint64_t bytes);
+    static uint64_t getVramBudget();
+
+    static Usage getUsage();
+    // @brief Returns a table of the usage of every category, one line per category.
+    static std::string getReport();
+    static const char* getCategoryName(MemoryCategory category);
+};
+
+// @brief Tags heap allocations made by the calling thread during the lifetime of the object.
+class MemoryScope
+{
+public:
+    explicit MemoryScope(MemoryCategory category);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryCategory previous;
+};
+
+#endif //KUMIGAME_DEBUG_MEMORY_TRACKER_HPP
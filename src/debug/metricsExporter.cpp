@@ -0,0 +1,304 @@
+#include "metricsExporter.hpp"
+#include "log.hpp"
+#include "../util/clock.hpp"
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // How long the server waits for a request before checking whether it should stop.
+    const int POLL_MILLISECONDS = 100;
+    const size_t MAX_REQUEST_SIZE = 4096;
+
+    std::string escapeLabel(const std::string& value)
+    {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (char c : value)
+        {
+            switch (c)
+            {
+                case '\\':
+                    escaped += "\\\\";
+                    break;
+                case '"':
+                    escaped += "\\\"";
+                    break;
+                case '\n':
+                    escaped += "\\n";
+                    break;
+                default:
+                    escaped += c;
+            }
+        }
+        return escaped;
+    }
+}
+
+MetricsExporter::MetricsExporter(const FrameTimeRecorder& frameTimes, std::string version, std::string renderer,
+                                 std::vector<std::pair<std::string, double>> loadTimes)
+    : frameTimes(frameTimes), version(std::move(version)), renderer(std::move(renderer)),
+      loadTimes(std::move(loadTimes))
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    running.store(false, std::memory_order_relaxed);
+    if (server.joinable())
+    {
+        server.join();
+    }
+#ifndef _WIN32
+    if (listenSocket >= 0)
+    {
+        close(listenSocket);
+    }
+#endif
+}
+
+std::optional<std::string> MetricsExporter::start(uint16_t port)
+{
+#ifdef _WIN32
+    return "The metrics exporter needs POSIX sockets.";
+#else
+    listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket < 0)
+    {
+        return fmt::format("Could not create a socket: {}", std::strerror(errno));
+    }
+
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Loopback only: the metrics are for a local agent or an SSH tunnel, not the network.
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listenSocket, 4) < 0)
+    {
+        std::string error = std::strerror(errno);
+        close(listenSocket);
+        listenSocket = -1;
+        return fmt::format("Could not listen on 127.0.0.1:{}: {}", port, error);
+    }
+
+    // The server has something to serve before the first snapshot is due.
+    snapshots.getWriteBuffer() = current;
+    snapshots.publish();
+    lastPublish = nowSeconds();
+
+    running.store(true, std::memory_order_relaxed);
+    server = std::thread(&MetricsExporter::serve, this);
+    LOG_INFO("Serving metrics at http://127.0.0.1:{}/metrics.", port);
+    return {};
+#endif
+}
+
+void MetricsExporter::recordFrame(float cpuMilliseconds, const GlCounters::Counts& counts)
+{
+    double seconds = cpuMilliseconds / 1000.0;
+    current.frames++;
+    current.frameSecondsSum += seconds;
+    size_t bucket = 0;
+    while (bucket < FRAME_BUCKETS.size() && seconds > FRAME_BUCKETS[bucket])
+    {
+        bucket++;
+    }
+    current.frameBuckets[bucket]++;
+
+    current.lastFrame = counts;
+    current.total.drawCalls += counts.drawCalls;
+    current.total.dispatches += counts.dispatches;
+    current.total.primitives += counts.primitives;
+    current.total.programBinds += counts.programBinds;
+    current.total.vertexArrayBinds += counts.vertexArrayBinds;
+    current.total.textureBinds += counts.textureBinds;
+    current.total.uniformUploads += counts.uniformUploads;
+    current.total.bufferBytes += counts.bufferBytes;
+    current.total.textureBytes += counts.textureBytes;
+
+    // Percentiles and memory use cost more to gather, so they are only taken for a snapshot.
+    double now = nowSeconds();
+    if (now - lastPublish < PUBLISH_INTERVAL)
+    {
+        return;
+    }
+    lastPublish = now;
+    current.cpu = frameTimes.getCpuSummary();
+    current.gpu = frameTimes.getGpuSummary();
+    current.memory = MemoryTracker::getUsage();
+    current.vramBudget = MemoryTracker::getVramBudget();
+    snapshots.getWriteBuffer() = current;
+    snapshots.publish();
+}
+
+void MetricsExporter::serve()
+{
+#ifndef _WIN32
+    while (running.load(std::memory_order_relaxed))
+    {
+        pollfd listening = { listenSocket, POLLIN, 0 };
+        if (poll(&listening, 1, POLL_MILLISECONDS) <= 0)
+        {
+            continue;
+        }
+
+        int client = accept(listenSocket, nullptr, nullptr);
+        if (client < 0)
+        {
+            continue;
+        }
+
+        // A client that stops sending or reading cannot hold the server for long.
+        timeval timeout = { 1, 0 };
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        respond(client);
+        close(client);
+    }
+#endif
+}
+
+void MetricsExporter::respond(int client)
+{
+#ifndef _WIN32
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE)
+    {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string status = "200 OK";
+    std::string body;
+    if (request.rfind("GET /metrics ", 0) == 0 || request.rfind("GET / ", 0) == 0)
+    {
+        body = format(snapshots.read());
+    }
+    else
+    {
+        status = "404 Not Found";
+        body = "Metrics are at /metrics.\n";
+    }
+
+    std::string response = fmt::format("HTTP/1.1 {}\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                                       "Content-Length: {}\r\nConnection: close\r\n\r\n", status, body.size()) + body;
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    size_t sent = 0;
+    while (sent < response.size())
+    {
+        ssize_t result = send(client, response.data() + sent, response.size() - sent, flags);
+        if (result <= 0)
+        {
+            return;
+        }
+        sent += static_cast<size_t>(result);
+    }
+#endif
+}
+
+std::string MetricsExporter::format(const Snapshot& snapshot) const
+{
+    std::string text;
+    auto header = [&text](const char* name, const char* type, const char* help) {
+        text += fmt::format("# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+    };
+
+    header("kumigame_info", "gauge", "Version of the game and the GL renderer.");
+    text += fmt::format("kumigame_info{{version=\"{}\",renderer=\"{}\"}} 1\n", escapeLabel(version),
+                        escapeLabel(renderer));
+
+    header("kumigame_frame_seconds", "histogram", "CPU time of each frame.");
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < FRAME_BUCKETS.size(); ++i)
+    {
+        cumulative += snapshot.frameBuckets[i];
+        text += fmt::format("kumigame_frame_seconds_bucket{{le=\"{}\"}} {}\n", FRAME_BUCKETS[i], cumulative);
+    }
+    text += fmt::format("kumigame_frame_seconds_bucket{{le=\"+Inf\"}} {}\n", snapshot.frames);
+    text += fmt::format("kumigame_frame_seconds_sum {:.6f}\n", snapshot.frameSecondsSum);
+    text += fmt::format("kumigame_frame_seconds_count {}\n", snapshot.frames);
+
+    header("kumigame_frame_time_seconds", "gauge", "Frame time percentiles over the last 1024 frames.");
+    for (const auto& [source, summary] : { std::make_pair("cpu", snapshot.cpu), std::make_pair("gpu", snapshot.gpu) })
+    {
+        for (const auto& [quantile, milliseconds] : { std::make_pair("0.5", summary.p50),
+                                                      std::make_pair("0.95", summary.p95),
+                                                      std::make_pair("0.99", summary.p99),
+                                                      std::make_pair("0.999", summary.p999),
+                                                      std::make_pair("1", summary.max) })
+        {
+            text += fmt::format("kumigame_frame_time_seconds{{source=\"{}\",quantile=\"{}\"}} {:.6g}\n", source,
+                                quantile, milliseconds / 1000.0);
+        }
+    }
+
+    if (GlCounters::ENABLED)
+    {
+        const std::array<std::pair<const char*, uint64_t GlCounters::Counts::*>, 9> kinds = {{
+            { "draw", &GlCounters::Counts::drawCalls },
+            { "dispatch", &GlCounters::Counts::dispatches },
+            { "primitive", &GlCounters::Counts::primitives },
+            { "program_bind", &GlCounters::Counts::programBinds },
+            { "vertex_array_bind", &GlCounters::Counts::vertexArrayBinds },
+            { "texture_bind", &GlCounters::Counts::textureBinds },
+            { "uniform_upload", &GlCounters::Counts::uniformUploads },
+            { "buffer_byte", &GlCounters::Counts::bufferBytes },
+            { "texture_byte", &GlCounters::Counts::textureBytes }
+        }};
+        header("kumigame_gl_last_frame", "gauge", "GL calls and uploaded bytes of the last frame.");
+        for (const auto& [kind, count] : kinds)
+        {
+            text += fmt::format("kumigame_gl_last_frame{{kind=\"{}\"}} {}\n", kind, snapshot.lastFrame.*count);
+        }
+        header("kumigame_gl_total", "counter", "GL calls and uploaded bytes since start.");
+        for (const auto& [kind, count] : kinds)
+        {
+            text += fmt::format("kumigame_gl_total{{kind=\"{}\"}} {}\n", kind, snapshot.total.*count);
+        }
+    }
+
+    header("kumigame_gpu_memory_bytes", "gauge", "Estimated GPU memory in use by category.");
+    for (size_t i = 0; i < snapshot.memory.gpu.size(); ++i)
+    {
+        text += fmt::format("kumigame_gpu_memory_bytes{{category=\"{}\"}} {}\n",
+                            MemoryTracker::getCategoryName(static_cast<MemoryCategory>(i)), snapshot.memory.gpu[i]);
+    }
+    header("kumigame_heap_memory_bytes", "gauge", "Heap memory allocated with new by category.");
+    for (size_t i = 0; i < snapshot.memory.cpu.size(); ++i)
+    {
+        text += fmt::format("kumigame_heap_memory_bytes{{category=\"{}\"}} {}\n",
+                            MemoryTracker::getCategoryName(static_cast<MemoryCategory>(i)), snapshot.memory.cpu[i]);
+    }
+    header("kumigame_vram_budget_bytes", "gauge", "GPU memory above which a warning is logged; 0 when disabled.");
+    text += fmt::format("kumigame_vram_budget_bytes {}\n", snapshot.vramBudget);
+
+    header("kumigame_load_seconds", "gauge", "Time taken by each stage of loading the assets.");
+    for (const auto& [stage, milliseconds] : loadTimes)
+    {
+        text += fmt::format("kumigame_load_seconds{{stage=\"{}\"}} {:.6g}\n", escapeLabel(stage), milliseconds / 1000.0);
+    }
+
+    return text;
+}
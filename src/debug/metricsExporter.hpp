@@ -0,0 +1,78 @@
+#ifndef KUMIGAME_DEBUG_METRICS_EXPORTER_HPP
+#define KUMIGAME_DEBUG_METRICS_EXPORTER_HPP
+
+#include "frameTimeRecorder.hpp"
+#include "glCounters.hpp"
+#include "memoryTracker.hpp"
+#include "../util/tripleBuffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Serves frame, renderer and memory statistics in the Prometheus text format at http://127.0.0.1:port/metrics.
+ *
+ * The main thread counts every frame and publishes a snapshot of the counts, frame time percentiles and memory use a
+ * few times a second through a triple buffer. The server thread formats whatever snapshot is latest, so a scrape never
+ * waits for or blocks the render loop. Only POSIX sockets are supported.
+ */
+class MetricsExporter
+{
+public:
+    MetricsExporter(const FrameTimeRecorder& frameTimes, std::string version, std::string renderer,
+                    std::vector<std::pair<std::string, double>> loadTimes);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // @brief Listens on the port of the loopback interface and starts serving.
+    std::optional<std::string> start(uint16_t port);
+    // @brief Counts a finished frame. Call once per frame on the main thread.
+    void recordFrame(float cpuMilliseconds, const GlCounters::Counts& counts);
+
+private:
+    // Upper bounds of the frame time histogram's buckets in seconds, before the implicit +Inf bucket.
+    static constexpr std::array<double, 8> FRAME_BUCKETS = { 0.004, 0.008, 0.012, 0.0167, 0.02, 0.0333, 0.05, 0.1 };
+    // Seconds between snapshots.
+    static constexpr double PUBLISH_INTERVAL = 0.25;
+
+    struct Snapshot
+    {
+        uint64_t frames = 0;
+        double frameSecondsSum = 0.0;
+        std::array<uint64_t, FRAME_BUCKETS.size() + 1> frameBuckets{};
+        FrameTimeRecorder::Summary cpu;
+        FrameTimeRecorder::Summary gpu;
+        GlCounters::Counts lastFrame;
+        GlCounters::Counts total;
+        MemoryTracker::Usage memory;
+        uint64_t vramBudget = 0;
+    };
+
+    const FrameTimeRecorder& frameTimes;
+    // Fixed before the server starts, so the server thread can read them freely.
+    const std::string version;
+    const std::string renderer;
+    const std::vector<std::pair<std::string, double>> loadTimes;
+
+    // Main thread only.
+    Snapshot current;
+    double lastPublish = 0.0;
+
+    TripleBuffer<Snapshot> snapshots;
+    std::thread server;
+    std::atomic<bool> running = false;
+    int listenSocket = -1;
+
+    void serve();
+    void respond(int client);
+    std::string format(const Snapshot& snapshot) const;
+};
+
+#endif //KUMIGAME_DEBUG_METRICS_EXPORTER_HPP
@@ -0,0 +1,246 @@
+#include "profiler.hpp"
+#include "flightRecorder.hpp"
+#include "log.hpp"
+#include "../util/string.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct Event
+    {
+        const char* name;
+        int64_t start;
+        int64_t end;
+    };
+
+    // Single producer, single consumer ring. Only the owning thread writes events and moves the head; only the main
+    // thread reads events and moves the tail.
+    struct ThreadBuffer
+    {
+        static const size_t CAPACITY = 1 << 14;
+
+        std::array<Event, CAPACITY> events;
+        std::atomic<size_t> head = 0;
+        std::atomic<size_t> tail = 0;
+        std::atomic<uint64_t> dropped = 0;
+        uint32_t id = 0;
+        std::string name;
+    };
+
+    struct CapturedEvent
+    {
+        Event event;
+        uint32_t thread;
+    };
+
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    // Capture state, only touched by the main thread.
+    bool continuous = false;
+    unsigned int framesLeft = 0;
+    unsigned int framesCaptured = 0;
+    std::string capturePath;
+    int64_t captureStart = 0;
+    std::vector<CapturedEvent> captured;
+
+    ThreadBuffer& getThreadBuffer()
+    {
+        if (!threadBuffer)
+        {
+            // Buffers live until exit so events of finished threads can still be collected.
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffers.push_back(std::make_unique<ThreadBuffer>());
+            threadBuffer = buffers.back().get();
+            threadBuffer->id = static_cast<uint32_t>(buffers.size());
+            threadBuffer->name = fmt::format("thread {}", threadBuffer->id);
+        }
+        return *threadBuffer;
+    }
+
+    void drain(bool keep)
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto& buffer : buffers)
+        {
+            size_t tail = buffer->tail.load(std::memory_order_relaxed);
+            size_t head = buffer->head.load(std::memory_order_acquire);
+            for (size_t i = tail; i != head; ++i)
+            {
+                const Event& event = buffer->events[i % ThreadBuffer::CAPACITY];
+                if (keep)
+                {
+                    captured.push_back({ event, buffer->id });
+                }
+                if (continuous)
+                {
+                    FlightRecorder::recordZone(event.name, buffer->id, event.start, event.end);
+                }
+            }
+            buffer->tail.store(head, std::memory_order_release);
+        }
+    }
+
+    std::optional<std::string> writeTrace(const std::string& path)
+    {
+        std::ofstream file(path);
+        if (!file)
+        {
+            return fmt::format("Could not open \"{}\" for writing.", path);
+        }
+
+        // Scopes open when the capture started begin before it, so the trace starts at the earliest scope.
+        int64_t origin = captureStart;
+        for (const auto& entry : captured)
+        {
+            origin = std::min(origin, entry.event.start);
+        }
+
+        // Chrome trace event format, with complete ("X") events in microseconds.
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            for (const auto& buffer : buffers)
+            {
+                file << (first ? "" : ",") << "\n" << fmt::format(
+                    R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+                    buffer->id, escapeJson(buffer->name));
+                first = false;
+            }
+        }
+        for (const auto& entry : captured)
+        {
+            file << (first ? "" : ",") << "\n" << fmt::format(
+                R"({{"name":"{}","cat":"cpu","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                escapeJson(entry.event.name), entry.thread,
+                static_cast<double>(entry.event.start - origin) / 1000.0,
+                static_cast<double>(entry.event.end - entry.event.start) / 1000.0);
+            first = false;
+        }
+        file << "\n]}\n";
+
+        if (!file)
+        {
+            return fmt::format("Failed to write \"{}\".", path);
+        }
+        return {};
+    }
+}
+
+std::optional<std::string> Profiler::beginCapture(unsigned int frames, const std::string& path)
+{
+    if (isCapturing())
+    {
+        return fmt::format("A capture of {} more frames is already running.", framesLeft);
+    }
+    if (frames == 0)
+    {
+        return "Capture at least one frame.";
+    }
+
+    // Drop anything other threads recorded after the previous capture ended.
+    drain(false);
+    captured.clear();
+    framesLeft = frames;
+    framesCaptured = 0;
+    capturePath = path;
+    captureStart = nowNanoseconds();
+    capturing.store(true, std::memory_order_relaxed);
+    recording.store(true, std::memory_order_relaxed);
+    return {};
+}
+
+void Profiler::endFrame()
+{
+    if (!isRecording())
+    {
+        return;
+    }
+
+    bool capture = isCapturing();
+    drain(capture);
+    if (!capture)
+    {
+        return;
+    }
+
+    framesCaptured++;
+    if (--framesLeft > 0)
+    {
+        return;
+    }
+
+    capturing.store(false, std::memory_order_relaxed);
+    recording.store(continuous, std::memory_order_relaxed);
+    // Pick up scopes other threads finished since the drain above.
+    drain(true);
+
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto& buffer : buffers)
+        {
+            dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+        }
+    }
+    if (dropped > 0)
+    {
+        LOG_WARN("Profiler dropped {} scopes because a thread's buffer was full.", dropped);
+    }
+
+    if (auto result = writeTrace(capturePath))
+    {
+        LOG_ERROR("Profiler: {}", result.value());
+    }
+    else
+    {
+        LOG_INFO("Wrote profile of {} frames ({} scopes) to \"{}\".", framesCaptured, captured.size(), capturePath);
+    }
+    captured.clear();
+    captured.shrink_to_fit();
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffer.name = name;
+}
+
+std::vector<std::pair<uint32_t, std::string>> Profiler::getThreadNames()
+{
+    std::vector<std::pair<uint32_t, std::string>> names;
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    for (const auto& buffer : buffers)
+    {
+        names.emplace_back(buffer->id, buffer->name);
+    }
+    return names;
+}
+
+void Profiler::setContinuous(bool enabled)
+{
+    continuous = enabled;
+    recording.store(continuous || isCapturing(), std::memory_order_relaxed);
+}
+
+void Profiler::record(const char* name, int64_t start, int64_t end)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    size_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= ThreadBuffer::CAPACITY)
+    {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[head % ThreadBuffer::CAPACITY] = { name, start, end };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,81 @@
+#ifndef KUMIGAME_DEBUG_PROFILER_HPP
+#define KUMIGAME_DEBUG_PROFILER_HPP
+
+#include "../util/clock.hpp"
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+// Records the time until the end of the enclosing scope. The name must be a string literal.
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+/**
+ * @brief Captures CPU time of PROFILE_SCOPE()s for a number of frames and writes it as a Chrome trace.
+ *
+ * Scopes are only recorded while a capture runs or recording is continuous, for the flight recorder; otherwise a
+ * scope costs one relaxed atomic load. Every thread writes
+ * finished scopes into its own ring buffer without locking, and the main thread drains all buffers once per frame.
+ * The written file opens in chrome://tracing or Perfetto, where scopes nest by time.
+ */
+class Profiler
+{
+public:
+    // @brief Starts capturing the next frames. Returns an error if a capture is already running.
+    static std::optional<std::string> beginCapture(unsigned int frames, const std::string& path);
+    // @brief Collects this frame's scopes and writes the trace after the last captured frame. Call once per frame.
+    static void endFrame();
+    // @brief Names the calling thread in captured traces.
+    static void setThreadName(const std::string& name);
+    // @brief Returns the id and name of every thread that recorded a scope or was named.
+    static std::vector<std::pair<uint32_t, std::string>> getThreadNames();
+    // @brief Records scopes outside captures too and hands them to the FlightRecorder once per frame.
+    static void setContinuous(bool continuous);
+
+    static bool isCapturing()
+    {
+        return capturing.load(std::memory_order_relaxed);
+    }
+
+    static bool isRecording()
+    {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    static void record(const char* name, int64_t start, int64_t end);
+
+private:
+    inline static std::atomic<bool> capturing = false;
+    // Set while capturing or continuous.
+    inline static std::atomic<bool> recording = false;
+};
+
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name)
+        : name(name), start(Profiler::isRecording() ? nowNanoseconds() : -1)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (start >= 0)
+        {
+            Profiler::record(name, start, nowNanoseconds());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#endif //KUMIGAME_DEBUG_PROFILER_HPP
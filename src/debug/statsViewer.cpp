@@ -1,13 +1,19 @@
 #include "statsViewer.hpp"
 #include "debugConsole.hpp"
+#include "glCounters.hpp"
+#include "memoryTracker.hpp"
 #include "../input/keyboard.hpp"
+#include "../util/clock.hpp"
 #include <glm/glm.hpp>
+#include <algorithm>
 #include <memory>
+#include <utility>
 #include <fmt/format.h>
 
-StatsViewer::StatsViewer(std::shared_ptr<TextRenderer>& textRenderer, glm::vec2 position, float sampleTime)
+StatsViewer::StatsViewer(std::shared_ptr<TextRenderer>& textRenderer, std::shared_ptr<Shader>& graphShader,
+                         glm::vec2 position, float sampleTime)
     : position(position), sampleTime(sampleTime),
-      renderer(textRenderer), lastTime(static_cast<float>(glfwGetTime()))
+      renderer(textRenderer), lastTime(nowSeconds()), lastFrameTime(lastTime), graph(graphShader)
 {
     // Toggle stats visibility.
     Keyboard::addKeyBinding([this]() {
@@ -57,50 +63,116 @@ void StatsViewer::processInput()
     }
 }
 
-void StatsViewer::update()
+void StatsViewer::update(float gpuMilliseconds)
 {
-    double currentTime = static_cast<float>(glfwGetTime());
+    double currentTime = nowSeconds();
+    frameTimes.record(static_cast<float>(1000.0 * (currentTime - lastFrameTime)), gpuMilliseconds);
+    lastFrameTime = currentTime;
+
     frames++;
     if (currentTime - lastTime >= sampleTime)
     {
-        ms = 100.0f / static_cast<float>(frames);
+        ms = static_cast<float>(1000.0 * (currentTime - lastTime) / frames);
         fps = 1000.0f / ms;
+        statsChanged = true;
 
         frames = 0;
-        lastTime += sampleTime;
+        lastTime = currentTime;
     }
 }
 
-void StatsViewer::render(const std::string& version, glm::ivec2 windowSize, glm::ivec2 renderSize, float superSampling)
+void StatsViewer::render(const std::string& version, glm::ivec2 windowSize, glm::ivec2 renderSize, float renderScale,
+                         const GpuProfiler& gpuProfiler)
 {
     // Update every one second.
     if (!hidden)
     {
-        glDisable(GL_DEPTH_TEST); // Keep text on top.
+        if (statsChanged || windowSize != shownWindowSize || renderSize != shownRenderSize || renderScale != shownRenderScale)
+        {
+            statsText = fmt::format("{0:.0f} ({1:.2f}ms)\n{2}\nWindow: {3}x{4}\nRendering: {5}x{6} ({7:.2f}x)",
+                                    fps, ms,
+                                    glGetString(GL_RENDERER),
+                                    windowSize.x, windowSize.y,
+                                    renderSize.x, renderSize.y,
+                                    renderScale);
 
-        // Prevent text from being drawn as wireframe/points.
-        int polygonMode;
-        glGetIntegerv(GL_POLYGON_MODE, &polygonMode);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+            // Tail latency over the recorded window; stutter shows here long before it moves the average.
+            FrameTimeRecorder::Summary cpu = frameTimes.getCpuSummary();
+            FrameTimeRecorder::Summary gpu = frameTimes.getGpuSummary();
+            for (const auto& [name, summary] : { std::pair("Frame", cpu), std::pair("GPU", gpu) })
+            {
+                statsText += fmt::format("\n{0} p50 {1:.2f} p95 {2:.2f} p99 {3:.2f} p99.9 {4:.2f} max {5:.2f}ms",
+                                         name, summary.p50, summary.p95, summary.p99, summary.p999, summary.max);
+            }
+            graphScale = std::max(1000.0f / 30.0f, cpu.max);
+            statsText += fmt::format("\nGraph: 0-{:.1f}ms over {} frames", graphScale, frameTimes.getCount());
+
+            if (GlCounters::ENABLED)
+            {
+                const GlCounters::Counts& counts = GlCounters::getFrame();
+                statsText += fmt::format("\nDraws: {} ({} primitives), dispatches: {}\n"
+                                         "Binds: {} programs, {} VAOs, {} textures\n"
+                                         "Uniforms: {}, uploaded: {:.1f}KB buffers, {:.1f}KB textures",
+                                         counts.drawCalls, counts.primitives, counts.dispatches,
+                                         counts.programBinds, counts.vertexArrayBinds, counts.textureBinds,
+                                         counts.uniformUploads, static_cast<double>(counts.bufferBytes) / 1024.0,
+                                         static_cast<double>(counts.textureBytes) / 1024.0);
+            }
+
+            MemoryTracker::Usage memory = MemoryTracker::getUsage();
+            uint64_t vramBudget = MemoryTracker::getVramBudget();
+            statsText += fmt::format("\nVRAM: {:.1f}", static_cast<double>(memory.gpuTotal) / (1024.0 * 1024.0));
+            if (vramBudget > 0)
+            {
+                statsText += fmt::format("/{:.0f}MB ({:.0f}%)", static_cast<double>(vramBudget) / (1024.0 * 1024.0),
+                                         100.0 * static_cast<double>(memory.gpuTotal) / static_cast<double>(vramBudget));
+            }
+            else
+            {
+                statsText += "MB";
+            }
+            statsText += fmt::format(", heap: {:.1f}MB", static_cast<double>(memory.cpuTotal) / (1024.0 * 1024.0));
+
+            // GPU time of each pass, indented by nesting.
+            std::vector<GpuProfiler::Timing> timings = gpuProfiler.getTimings();
+            if (!timings.empty())
+            {
+                statsText += "\nGPU passes:";
+                for (const auto& timing : timings)
+                {
+                    statsText += fmt::format("\n{0:>{1}}{2} {3:.2f}ms", "", 2 * (timing.depth + 1), timing.name,
+                                             timing.milliseconds);
+                }
+            }
+            statsChanged = false;
+            shownWindowSize = windowSize;
+            shownRenderSize = renderSize;
+            shownRenderScale = renderScale;
+        }
+        if (versionText.empty())
+        {
+            versionText = fmt::format("{}\nOpenGL {}.{}", version, GLVersion.major, GLVersion.minor);
+        }
+
+        // Draw the frame times of the window in the bottom-right corner.
+        glm::vec2 graphSize(300.0f, 100.0f);
+        frameTimes.getCpuTimes(graphTimes);
+        graph.render(graphTimes, glm::vec2(windowSize) - glm::vec2(graphSize.x + 20.0f, 20.0f), graphSize, graphScale,
+                     windowSize, glm::vec4(1.0f, 1.0f, 0.0f, 0.7f));
 
         // Draw FPS and ms/frame.
-        auto out = fmt::format("{0:.0f} ({1:.2f}ms)\n{2}\nWindow: {3}x{4}\nRendering: {5}x{6} ({7}x)",
-                               fps, ms,
-                               glGetString(GL_RENDERER),
-                               windowSize.x, windowSize.y,
-                               renderSize.x, renderSize.y,
-                               superSampling);
-        renderer->render(out, glm::vec2(position.x, position.y), 1.0f, glm::vec4(1.0f, 1.0f, 0.0f, 0.7f));
+        renderer->render(statsText, glm::vec2(position.x, position.y), 1.0f, glm::vec4(1.0f, 1.0f, 0.0f, 0.7f));
 
         // Draw version.
-        out = fmt::format("{}\nOpenGL {}.{}", version, GLVersion.major, GLVersion.minor);
-        renderer->render(out, glm::vec2(windowSize.x - 20, 20), 1.0f, glm::vec4(1.0f, 1.0f, 0.0f, 0.7f), true);
-
-        glPolygonMode(GL_FRONT_AND_BACK, polygonMode);
-        glEnable(GL_DEPTH_TEST); // Restore depth testing.
+        renderer->render(versionText, glm::vec2(windowSize.x - 20, 20), 1.0f, glm::vec4(1.0f, 1.0f, 0.0f, 0.7f), true);
     }
 }
 
+const FrameTimeRecorder& StatsViewer::getFrameTimes() const
+{
+    return frameTimes;
+}
+
 void StatsViewer::toggleHidden()
 {
     hidden = !hidden;
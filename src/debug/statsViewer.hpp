@@ -1,6 +1,9 @@
 #ifndef KUMIGAME_DEBUG_STATS_VIEWER_HPP
 #define KUMIGAME_DEBUG_STATS_VIEWER_HPP
 
+#include "frameTimeGraph.hpp"
+#include "frameTimeRecorder.hpp"
+#include "../renderer/gpuProfiler.hpp"
 #include "../renderer/textRenderer.hpp"
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -14,18 +17,38 @@ public:
     float sampleTime;
     bool hidden = true;
 
-    StatsViewer(std::shared_ptr<TextRenderer>& textRenderer, glm::vec2 position, float sampleTime = 0.1f);
+    StatsViewer(std::shared_ptr<TextRenderer>& textRenderer, std::shared_ptr<Shader>& graphShader, glm::vec2 position,
+                float sampleTime = 0.1f);
 
     void processInput();
-    void update();
-    void render(const std::string& version, glm::ivec2 windowSize, glm::ivec2 renderSize, float superSampling);
+    // @brief Records the frame that just ended, with the latest GPU frame time available.
+    void update(float gpuMilliseconds);
+    void render(const std::string& version, glm::ivec2 windowSize, glm::ivec2 renderSize, float renderScale,
+                const GpuProfiler& gpuProfiler);
+
+    const FrameTimeRecorder& getFrameTimes() const;
 
 private:
     std::shared_ptr<TextRenderer> renderer;
     int frames = 0;
     float fps = 0;
     float ms = 0;
-    float lastTime;
+    double lastTime;
+    double lastFrameTime;
+
+    FrameTimeRecorder frameTimes;
+    FrameTimeGraph graph;
+    std::vector<float> graphTimes;
+    // Frame time at the top of the graph.
+    float graphScale = 1000.0f / 30.0f;
+
+    // Formatted text, rebuilt only when one of the values shown changes.
+    bool statsChanged = true;
+    std::string statsText;
+    std::string versionText;
+    glm::ivec2 shownWindowSize{};
+    glm::ivec2 shownRenderSize{};
+    float shownRenderScale = 0.0f;
 
     void toggleHidden();
     void togglePolygonMode();
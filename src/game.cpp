@@ -1,19 +1,31 @@
 #include "game.hpp"
+#include "debug/glCounters.hpp"
 #include "debug/glDebug.hpp"
+#include "debug/flightRecorder.hpp"
 #include "debug/log.hpp"
+#include "debug/memoryTracker.hpp"
+#include "debug/profiler.hpp"
 #include "input/keyboard.hpp"
 #include "renderer/material.hpp"
 #include "renderer/postProcess.hpp"
+#include "util/clock.hpp"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <optional>
 #include <stb_image.h>
 
 Game::~Game()
 {
-    //glDeleteFramebuffers(1, &fbo);
-    glfwDestroyWindow(window);
+    renderGraph.reset();
+    temporalUpscaler.reset();
+    renderTargets.reset();
+    gpuProfiler.reset();
+    if (window)
+    {
+        glfwDestroyWindow(window);
+    }
     glfwTerminate();
 }
 
@@ -29,29 +41,210 @@ std::optional<std::string> Game::run()
         return "Failed to load assets.";
     }
 
-    float lastFrame = 0.0f;
+    // Pick graphics settings for this machine on the first launch.
+    if (!settings.calibrated)
+    {
+        startCalibration();
+    }
+
+    const int64_t tickTime = 1000000000 / settings.tickRate;
+    const auto tickSeconds = static_cast<float>(static_cast<double>(tickTime) / 1e9);
+    int64_t lastFrame = nowNanoseconds();
+    previousCameraPosition = tickCameraPosition = camera->position;
+    previousCameraOrientation = tickCameraOrientation = { camera->yaw, camera->pitch };
 
     while (!glfwWindowShouldClose(window))
     {
-        auto currentFrame = static_cast<float>(glfwGetTime());
-        float deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+        int64_t start = nowNanoseconds();
+        int64_t frameTime = start - lastFrame;
+        lastFrame = start;
+
+        {
+            PROFILE_SCOPE("frame");
+            bool capturingInput = inputRecorder->isRecording() || inputRecorder->isReplaying();
+            processInput(frameTime);
 
-        processInput(deltaTime);
-        update();
-        draw();
+            // Recordings and replays start on a tick, with no ticks in the frame that starts them, so a replay ticks
+            // on the same frames as its recording.
+            if (!capturingInput && (inputRecorder->isRecording() || inputRecorder->isReplaying()))
+            {
+                tickLag = 0;
+            }
+            else
+            {
+                // Advance the simulation in fixed ticks, each handling the input that arrived before it ends. After a
+                // long frame only a few ticks catch up and the rest of the time is skipped, so a frame too slow for
+                // its ticks cannot make every following frame slower still.
+                tickLag += frameTime;
+                int ticks = 0;
+                while (tickLag >= tickTime && ticks < settings.maxTicksPerFrame)
+                {
+                    tick(start - tickLag + tickTime, tickSeconds);
+                    tickLag -= tickTime;
+                    ticks++;
+                }
+                if (tickLag >= tickTime)
+                {
+                    LOG_DEBUG("Skipped {} ticks after a {:.1f} ms frame.", tickLag / tickTime,
+                              static_cast<double>(frameTime) / 1e6);
+                    tickLag %= tickTime;
+                }
+            }
+
+            update();
+
+            // Show the camera between the last two ticks. Whatever else moved or turned it, e.g. a camera path, did so
+            // at once.
+            glm::vec2 orientation(camera->yaw, camera->pitch);
+            if (camera->position != tickCameraPosition || orientation != tickCameraOrientation)
+            {
+                previousCameraPosition = tickCameraPosition = camera->position;
+                previousCameraOrientation = tickCameraOrientation = orientation;
+            }
+            float alpha = static_cast<float>(static_cast<double>(tickLag) / static_cast<double>(tickTime));
+            glm::vec2 interpolatedOrientation = glm::mix(previousCameraOrientation, tickCameraOrientation, alpha);
+            camera->position = glm::mix(previousCameraPosition, tickCameraPosition, alpha);
+            camera->setOrientation(interpolatedOrientation.x, interpolatedOrientation.y);
+            draw();
+            camera->position = tickCameraPosition;
+            camera->setOrientation(tickCameraOrientation.x, tickCameraOrientation.y);
+        }
+        Profiler::endFrame();
+        auto cpuMilliseconds = static_cast<float>(static_cast<double>(nowNanoseconds() - start) / 1e6);
+        FlightRecorder::endFrame(cpuMilliseconds, gpuProfiler->getFrameMilliseconds(), GlCounters::getFrame());
+        if (metricsExporter)
+        {
+            metricsExporter->recordFrame(cpuMilliseconds, GlCounters::getFrame());
+        }
     }
 
     return {};
 }
 
+std::optional<std::string> Game::runBenchmark(const BenchmarkOptions& options, BenchmarkResults& results)
+{
+    if (options.scene != "default")
+    {
+        return fmt::format("Unknown scene \"{}\". The only scene is \"default\".", options.scene);
+    }
+
+    CameraPath path;
+    if (auto result = path.loadFromFile(options.pathFile))
+    {
+        return result;
+    }
+
+    benchmark = options;
+    if (auto result = init())
+    {
+        return fmt::format("Failed to initialize: {}", result.value());
+    }
+
+    if (auto result = loadAssets())
+    {
+        return "Failed to load assets.";
+    }
+
+    results.version = VERSION.toLongString();
+    results.renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    results.resolution = windowSize;
+    results.loadTimes = loadTimes;
+    results.frames.reserve(options.frames);
+
+    LOG_INFO("Benchmarking scene \"{}\" along \"{}\" for {} frames at {}x{}.", options.scene, options.pathFile,
+             options.frames, windowSize.x, windowSize.y);
+
+    unsigned int totalFrames = options.warmupFrames + options.frames;
+    for (unsigned int frame = 0; frame < totalFrames; ++frame)
+    {
+        // The camera follows the frame number rather than the clock, so every run renders the same images. Warm-up
+        // frames stay at the start of the path.
+        unsigned int measuredFrame = frame < options.warmupFrames ? 0 : frame - options.warmupFrames;
+        float progress = options.frames > 1
+            ? static_cast<float>(measuredFrame) / static_cast<float>(options.frames - 1) : 0.0f;
+        path.apply(*camera, progress * path.getDuration());
+
+        int64_t start = nowNanoseconds();
+        {
+            PROFILE_SCOPE("frame");
+            update();
+            draw();
+        }
+        Profiler::endFrame();
+        auto cpuMilliseconds = static_cast<float>(static_cast<double>(nowNanoseconds() - start) / 1e6);
+
+        // Nothing throttles an offscreen context, so wait for the GPU to keep frames from queueing up. The wait is
+        // GPU time and is left out of the CPU time above.
+        if (headlessContext)
+        {
+            glFinish();
+        }
+
+        if (frame >= options.warmupFrames)
+        {
+            results.frames.push_back({ cpuMilliseconds, gpuProfiler->getFrameMilliseconds(), GlCounters::getFrame() });
+        }
+    }
+
+    results.memory = MemoryTracker::getUsage();
+    return {};
+}
+
 std::optional<std::string> Game::init()
 {
     readSettings(settings, SETTINGS_PATH);
     changeLogLevels(settings.consoleLogLevel, settings.fileLogLevel);
 
     LOG_INFO("Version {}", VERSION.toLongString());
+    Profiler::setThreadName("main");
+    if (settings.flightRecorder)
+    {
+        FlightRecorder::enable(settings.flightRecorderSeconds, settings.hitchFactor);
+    }
+    MemoryTracker::setVramBudget(static_cast<uint64_t>(settings.vramBudget) * 1024 * 1024);
 
+    if (benchmark)
+    {
+        // Measure the same work on every run, whatever the frame time.
+        settings.dynamicResolution = false;
+        settings.vSync = false;
+        if (benchmark->resolution.x > 0)
+        {
+            settings.width = benchmark->resolution.x;
+            settings.height = benchmark->resolution.y;
+        }
+    }
+
+    dynamicResolution = std::make_unique<DynamicResolution>(settings.targetFrameTime,
+                                                            settings.minRenderScale, settings.maxRenderScale);
+
+    if (auto result = benchmark ? createOffscreenContext() : createWindow())
+    {
+        return result;
+    }
+
+    GLADloadproc loader = headlessContext ? HeadlessContext::getLoader()
+                                          : reinterpret_cast<GLADloadproc>(glfwGetProcAddress);
+    if (!gladLoadGLLoader(loader))
+    {
+        return "Failed to initialize GLAD.";
+    }
+
+    // Only counts anything when built with KUMIGAME_GL_COUNTERS.
+    GlCounters::install();
+
+    LOG_INFO("OpenGL {}.{}", GLVersion.major, GLVersion.minor);
+    LOG_INFO("Graphics device: {}", glGetString(GL_RENDERER));
+    LOG_INFO("Resolution: {}x{}", windowSize.x, windowSize.y);
+
+    // Asynchronous unless a call site is needed; see "set glsync".
+    GlDebug::install();
+
+    return {};
+}
+
+std::optional<std::string> Game::createWindow()
+{
     // Initialize GLFW.
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -64,6 +257,8 @@ std::optional<std::string> Game::init()
 #ifndef NDEBUG
     glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
 #endif
+    // The benchmark falls back to a hidden window when it cannot create an offscreen context.
+    glfwWindowHint(GLFW_VISIBLE, benchmark ? GLFW_FALSE : GLFW_TRUE);
 
     glfwSetErrorCallback([](int error, const char* description) {
         LOG_ERROR("GLFW error (code {}): {}", error, description);
@@ -83,7 +278,7 @@ std::optional<std::string> Game::init()
     // Save window position and size.
     glfwGetWindowPos(window, &windowPos.x, &windowPos.y);
     glfwGetWindowSize(window, &windowSize.x, &windowSize.y);
-    renderSize = glm::ivec2(windowSize.x * settings.superSampling, windowSize.y * settings.superSampling);
+    updateRenderSize();
 
     // Get window content scale;
     float xScale, yScale;
@@ -98,33 +293,10 @@ std::optional<std::string> Game::init()
     GLFWimage images[2] = { icon, iconSmall };
     glfwSetWindowIcon(window, 2, images);
 
-    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
-    {
-        return "Failed to initialize GLAD.";
-    }
-
-    LOG_INFO("OpenGL {}.{}", GLVersion.major, GLVersion.minor);
-    LOG_INFO("Graphics device: {}", glGetString(GL_RENDERER));
-    LOG_INFO("Resolution: {}x{}", windowSize.x, windowSize.y);
-
-    GLint flags;
-    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
-    if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
-    {
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-        glDebugMessageCallback(glDebugOutput, nullptr);
-        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
-    }
-
     glfwSetFramebufferSizeCallback(window, [](GLFWwindow* window, int width, int height) {
-        glViewport(0, 0, width, height);
         auto game = static_cast<Game*>(glfwGetWindowUserPointer(window));
         game->windowSize = { width, height };
-        game->renderSize = {
-            width * static_cast<int>(game->settings.superSampling),
-            height * static_cast<int>(game->settings.superSampling)
-        };
+        game->updateRenderSize();
     });
 
     glfwSetWindowPosCallback(window, [](GLFWwindow* window, int xPos, int yPos) {
@@ -132,28 +304,26 @@ std::optional<std::string> Game::init()
         game->windowPos = { xPos, yPos };
     });
 
+    // Input is only queued here and handled in processInput(), through the recorder.
+    inputQueue = std::make_unique<InputQueue>();
     glfwSetCursorPosCallback(window, [](GLFWwindow* window, double xPos, double yPos) {
         auto game = static_cast<Game*>(glfwGetWindowUserPointer(window));
-        if (game->debugConsole->hidden)
-        {
-            game->camera->processMouseMovement(xPos, yPos);
-        }
+        game->inputQueue->pushCursorPos(xPos, yPos);
     });
 
-    glfwSetScrollCallback(window, [](GLFWwindow* window, double, double yOffset) {
+    glfwSetScrollCallback(window, [](GLFWwindow* window, double xOffset, double yOffset) {
         auto game = static_cast<Game*>(glfwGetWindowUserPointer(window));
-        if (game->debugConsole->hidden)
-        {
-            game->camera->processMouseScroll(yOffset);
-        }
+        game->inputQueue->pushScroll(xOffset, yOffset);
     });
 
-    glfwSetKeyCallback(window, [](GLFWwindow*, int key, int, int action, int mods) {
-        Keyboard::onKeyEvent(key, action, mods);
+    glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods) {
+        auto game = static_cast<Game*>(glfwGetWindowUserPointer(window));
+        game->inputQueue->pushKey(key, scancode, action, mods);
     });
 
-    glfwSetCharCallback(window, [](GLFWwindow*, unsigned int codePoint) {
-        Keyboard::onCharEvent(codePoint);
+    glfwSetCharCallback(window, [](GLFWwindow* window, unsigned int codePoint) {
+        auto game = static_cast<Game*>(glfwGetWindowUserPointer(window));
+        game->inputQueue->pushChar(codePoint);
     });
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -163,20 +333,44 @@ std::optional<std::string> Game::init()
     return {};
 }
 
+std::optional<std::string> Game::createOffscreenContext()
+{
+#ifndef NDEBUG
+    const bool debugContext = true;
+#else
+    const bool debugContext = false;
+#endif
+
+    headlessContext = std::make_unique<HeadlessContext>();
+    if (auto result = headlessContext->create(4, 3, debugContext))
+    {
+        LOG_WARN("Could not create an offscreen context, using a hidden window instead: {}", result.value());
+        headlessContext.reset();
+        return createWindow();
+    }
+
+    windowSize = { settings.width, settings.height };
+    updateRenderSize();
+    return {};
+}
+
 std::optional<std::string> Game::loadAssets()
 {
+    PROFILE_SCOPE("Game::loadAssets");
     LOG_INFO("Loading assets...");
-    double assetsTime = glfwGetTime();
-    double time = glfwGetTime();
+    double assetsTime = nowSeconds();
+    double time = nowSeconds();
 
     // Load shaders.
     screenShader = std::make_shared<Shader>("assets/shaders/screen.vert", "assets/shaders/screen.frag");
     auto textShader = std::make_shared<Shader>("assets/shaders/text.vert", "assets/shaders/text.frag");
     meshShader = std::make_shared<Shader>("assets/shaders/mesh.vert", "assets/shaders/mesh.frag");
     lampShader = std::make_shared<Shader>("assets/shaders/mesh.vert", "assets/shaders/lamp.frag");
-    LOG_INFO("Loaded shaders ({:.3f} ms).", 1000 * (glfwGetTime() - time));
+    graphShader = std::make_shared<Shader>("assets/shaders/graph.vert", "assets/shaders/graph.frag");
+    loadTimes.emplace_back("shaders", 1000 * (nowSeconds() - time));
+    LOG_INFO("Loaded shaders ({:.3f} ms).", loadTimes.back().second);
 
-    time = glfwGetTime();
+    time = nowSeconds();
 
     float quadVertices[] = {
         // positions   // texCoords
@@ -193,6 +387,7 @@ std::optional<std::string> Game::loadAssets()
     glBindVertexArray(quadVAO);
     glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
+    MemoryTracker::trackBuffer(quadVBO, MemoryCategory::General, sizeof(quadVertices));
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(1);
@@ -201,28 +396,15 @@ std::optional<std::string> Game::loadAssets()
     screenShader->use();
     screenShader->setInteger("ScreenTexture", 0);
 
-    glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-
-    glGenTextures(1, &texColorBuffer);
-    glBindTexture(GL_TEXTURE_2D, texColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, renderSize.x, renderSize.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texColorBuffer, 0);
-
-    glGenRenderbuffers(1, &rbo);
-    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, renderSize.x, renderSize.y);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, rbo);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-    {
-        LOG_ERROR("Framebuffer is not complete!");
-    }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Render targets are created on first use in draw(), which declares the frame as a render graph.
+    renderTargets = std::make_unique<RenderTargetManager>();
+    gpuProfiler = std::make_unique<GpuProfiler>();
+    renderGraph = std::make_unique<RenderGraph>(*renderTargets);
+    renderGraph->setProfiler(gpuProfiler.get());
+    postProcessChain = std::make_unique<PostProcessChain>(quadVAO);
+    temporalUpscaler = std::make_unique<TemporalUpscaler>(quadVAO);
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    applyAntiAliasing();
 
     // Text renderer.
     textRenderer = std::make_shared<TextRenderer>(settings.width, settings.height, textShader, "assets/fonts/OCRAEXT.TTF", 14);
@@ -231,14 +413,28 @@ std::optional<std::string> Game::loadAssets()
     debugConsole = std::make_unique<DebugConsole>(textRenderer, glm::vec2(20.0f, static_cast<float>(settings.height) - 20.0f));
 
     // Stats viewer.
-    statsViewer = std::make_unique<StatsViewer>(textRenderer, glm::vec2(20.0f));
+    statsViewer = std::make_unique<StatsViewer>(textRenderer, graphShader, glm::vec2(20.0f));
+
+    // Close window on Escape.
+    Keyboard::addKeyBinding([this]() {
+        glfwSetWindowShouldClose(window, true);
+    }, GLFW_KEY_ESCAPE, GLFW_RELEASE);
 
     // Camera
     camera = std::make_unique<Camera>();
 
-    LOG_INFO("Loaded classes ({:.3f} ms).", 1000 * (glfwGetTime() - time));
+    // Input recorder.
+    inputRecorder = std::make_unique<InputRecorder>(InputRecorder::Handlers{
+        .key = [this](int key, int scancode, int action, int mods) { onKey(key, scancode, action, mods); },
+        .character = [this](unsigned int codePoint) { onChar(codePoint); },
+        .cursorPos = [this](double xPos, double yPos) { onCursorPos(xPos, yPos); },
+        .scroll = [this](double xOffset, double yOffset) { onScroll(xOffset, yOffset); }
+    });
+
+    loadTimes.emplace_back("classes", 1000 * (nowSeconds() - time));
+    LOG_INFO("Loaded classes ({:.3f} ms).", loadTimes.back().second);
 
-    time = glfwGetTime();
+    time = nowSeconds();
     // Load models.
     nanosuit = std::make_unique<Model>("assets/models/nanosuit/nanosuit.obj");
     cube = std::make_unique<Model>("assets/models/cube/cube.obj");
@@ -251,23 +447,73 @@ std::optional<std::string> Game::loadAssets()
     };
     lampMaterialIndex = cube->addMeshMaterial(0, lampMaterial);
 
-    LOG_INFO("Loaded models ({:.3f} ms).", 1000 * (glfwGetTime() - time));
+    loadTimes.emplace_back("models", 1000 * (nowSeconds() - time));
+    LOG_INFO("Loaded models ({:.3f} ms).", loadTimes.back().second);
 
-    LOG_INFO("Finished loading assets ({:.3f} ms).", 1000 * (glfwGetTime() - assetsTime));
+    loadTimes.emplace_back("total", 1000 * (nowSeconds() - assetsTime));
+    LOG_INFO("Finished loading assets ({:.3f} ms).", loadTimes.back().second);
+
+    // Metrics exporter. The benchmark writes its own report instead.
+    if (settings.metrics && !benchmark)
+    {
+        metricsExporter = std::make_unique<MetricsExporter>(statsViewer->getFrameTimes(), VERSION.toLongString(),
+                                                            reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+                                                            loadTimes);
+        if (auto result = metricsExporter->start(static_cast<uint16_t>(settings.metricsPort)))
+        {
+            LOG_ERROR("Failed to start the metrics exporter: {}", result.value());
+            metricsExporter.reset();
+        }
+    }
 
     return {};
 }
 
-void Game::processInput(float deltaTime)
+void Game::processInput(int64_t& frameTime)
 {
+    PROFILE_SCOPE("Game::processInput");
+    inputRecorder->beginFrame(frameTime);
     glfwPollEvents();
 
-    Keyboard::processKeys(window);
+    // Keys held when a replay ends are not necessarily held on the keyboard.
+    if (replayingInput && !inputRecorder->isReplaying())
+    {
+        Keyboard::poll(window);
+    }
+    replayingInput = inputRecorder->isReplaying();
 
     // Process console commands.
     if (!(DebugConsole::command.processed || DebugConsole::command.empty()))
     {
-        if (DebugConsole::command.size() == 2)
+        if (DebugConsole::command.size() == 1)
+        {
+            if (DebugConsole::command[0] == "mem" || DebugConsole::command[0] == "memory")
+            {
+                DebugConsole::command.response = MemoryTracker::getReport();
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "gldebug")
+            {
+                DebugConsole::command.response = GlDebug::getReport();
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "calibrate")
+            {
+                if (calibrator)
+                {
+                    DebugConsole::command.response = "Already calibrating.";
+                }
+                else
+                {
+                    startCalibration();
+                    DebugConsole::command.response = calibrator
+                        ? std::string("Calibrating graphics settings...")
+                        : std::string("Failed to calibrate; see the log.");
+                }
+                DebugConsole::command.processed = true;
+            }
+        }
+        else if (DebugConsole::command.size() == 2)
         {
             if ((DebugConsole::command[0] == "exit" || DebugConsole::command[0] == "close") && DebugConsole::command[1] == "game")
             {
@@ -281,10 +527,94 @@ void Game::processInput(float deltaTime)
                 DebugConsole::command.processed = true;
                 DebugConsole::command.response = fmt::format("Settings saved at \"{}\".", SETTINGS_PATH);
             }
+            else if (DebugConsole::command[0] == "flight" && DebugConsole::command[1] == "dump")
+            {
+                if (auto error = FlightRecorder::dump("command"))
+                {
+                    DebugConsole::command.response = error.value();
+                }
+                else
+                {
+                    DebugConsole::command.response = "Writing the flight recording to logs/.";
+                }
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "input" && DebugConsole::command[1] == "record")
+            {
+                if (auto error = inputRecorder->startRecording(INPUT_PATH, *camera))
+                {
+                    DebugConsole::command.response = error.value();
+                }
+                else
+                {
+                    DebugConsole::command.response = fmt::format("Recording input to \"{}\".", INPUT_PATH);
+                }
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "input" && DebugConsole::command[1] == "replay")
+            {
+                if (auto error = inputRecorder->startReplay(INPUT_PATH, *camera))
+                {
+                    DebugConsole::command.response = error.value();
+                }
+                else
+                {
+                    DebugConsole::command.response = fmt::format("Replaying {} frames from \"{}\".",
+                                                                 inputRecorder->getReplayFrames(), INPUT_PATH);
+                }
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "input" && DebugConsole::command[1] == "stop")
+            {
+                inputRecorder->stop();
+                DebugConsole::command.processed = true;
+                DebugConsole::command.response = "Stopped recording or replaying input.";
+            }
         }
         else if (DebugConsole::command.size() == 3)
         {
-            if (DebugConsole::command[0] == "set")
+            if (DebugConsole::command[0] == "profile" && DebugConsole::command[1] == "capture")
+            {
+                try
+                {
+                    int frames = std::stoi(DebugConsole::command[2]);
+                    if (auto error = Profiler::beginCapture(static_cast<unsigned int>(std::max(frames, 0)), PROFILE_PATH))
+                    {
+                        DebugConsole::command.response = error.value();
+                    }
+                    else
+                    {
+                        DebugConsole::command.response = fmt::format("Capturing {} frames to \"{}\".", frames, PROFILE_PATH);
+                    }
+                }
+                catch (std::invalid_argument& ex)
+                {
+                    DebugConsole::command.response = "Invalid argument: must be of type int.";
+                }
+
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "input" && DebugConsole::command[1] == "replay" &&
+                     DebugConsole::command[2] == "profile")
+            {
+                // Profiles exactly the replayed frames, so runs of the same recording can be compared.
+                if (auto error = inputRecorder->startReplay(INPUT_PATH, *camera))
+                {
+                    DebugConsole::command.response = error.value();
+                }
+                else if (auto captureError = Profiler::beginCapture(inputRecorder->getReplayFrames(), PROFILE_PATH))
+                {
+                    inputRecorder->stop();
+                    DebugConsole::command.response = captureError.value();
+                }
+                else
+                {
+                    DebugConsole::command.response = fmt::format("Replaying and capturing {} frames to \"{}\".",
+                                                                 inputRecorder->getReplayFrames(), PROFILE_PATH);
+                }
+                DebugConsole::command.processed = true;
+            }
+            else if (DebugConsole::command[0] == "set")
             {
                 // TODO: Support windowed fullscreen.
                 if (DebugConsole::command[1] == "fullscreen")
@@ -344,21 +674,174 @@ void Game::processInput(float deltaTime)
 
                     DebugConsole::command.processed = true;
                 }
+                else if (DebugConsole::command[1] == "glsync")
+                {
+                    if (DebugConsole::command[2] == "true" || DebugConsole::command[2] == "on")
+                    {
+                        GlDebug::setSynchronous(true);
+                        DebugConsole::command.response = "OpenGL messages are reported inside the call causing them.";
+                    }
+                    else if (DebugConsole::command[2] == "false" || DebugConsole::command[2] == "off")
+                    {
+                        GlDebug::setSynchronous(false);
+                        DebugConsole::command.response = "OpenGL messages are reported asynchronously.";
+                    }
+                    else
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type bool.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
                 else if (DebugConsole::command[1] == "supersampling")
                 {
                     try
                     {
                         settings.superSampling = std::stof(DebugConsole::command[2]);
-                        renderSize = {
-                            windowSize.x * settings.superSampling,
-                            windowSize.y * settings.superSampling
-                        };
+                        updateRenderSize();
+                        DebugConsole::command.response = fmt::format("Set supersampling to {:.2f}x.", settings.superSampling);
                     }
                     catch (std::invalid_argument& ex)
                     {
                         DebugConsole::command.response = "Invalid argument: must be of type float.";
                     }
 
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "aa" || DebugConsole::command[1] == "antialiasing")
+                {
+                    if (auto mode = antiAliasingFromString(DebugConsole::command[2]))
+                    {
+                        settings.antiAliasing = mode.value();
+                        applyAntiAliasing();
+                        DebugConsole::command.response = fmt::format("Set anti-aliasing to {}.", antiAliasingToString(settings.antiAliasing));
+                    }
+                    else
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be off, msaa2, msaa4, msaa8 or fxaa.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "pointlights")
+                {
+                    try
+                    {
+                        settings.pointLights = std::clamp(std::stoi(DebugConsole::command[2]), 1, 4);
+                        DebugConsole::command.response = fmt::format("Set point lights to {}.", settings.pointLights);
+                    }
+                    catch (std::invalid_argument& ex)
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type int.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "blur")
+                {
+                    try
+                    {
+                        postProcessChain->blurRadius = std::clamp(std::stoi(DebugConsole::command[2]), 1, PostProcessChain::MAX_BLUR_RADIUS);
+                        DebugConsole::command.response = fmt::format("Set blur radius to {} px.", postProcessChain->blurRadius);
+                    }
+                    catch (std::invalid_argument& ex)
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type int.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "dynamicres")
+                {
+                    if (DebugConsole::command[2] == "true" || DebugConsole::command[2] == "on")
+                    {
+                        settings.dynamicResolution = true;
+                        dynamicResolution->reset(renderScale);
+                        updateRenderSize();
+                        DebugConsole::command.response = "Dynamic resolution enabled.";
+                    }
+                    else if (DebugConsole::command[2] == "false" || DebugConsole::command[2] == "off")
+                    {
+                        settings.dynamicResolution = false;
+                        updateRenderSize();
+                        DebugConsole::command.response = "Dynamic resolution disabled.";
+                    }
+                    else
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type bool.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "targetframetime")
+                {
+                    try
+                    {
+                        settings.targetFrameTime = std::stof(DebugConsole::command[2]);
+                        dynamicResolution->targetFrameTime = settings.targetFrameTime;
+                        DebugConsole::command.response = fmt::format("Set target frame time to {:.2f} ms.", settings.targetFrameTime);
+                    }
+                    catch (std::invalid_argument& ex)
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type float.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "taa")
+                {
+                    if (DebugConsole::command[2] == "true" || DebugConsole::command[2] == "on")
+                    {
+                        settings.temporalUpsampling = true;
+                        temporalUpscaler->invalidate();
+                        applyAntiAliasing();
+                        updateRenderSize();
+                        DebugConsole::command.response = "Temporal upsampling enabled.";
+                    }
+                    else if (DebugConsole::command[2] == "false" || DebugConsole::command[2] == "off")
+                    {
+                        settings.temporalUpsampling = false;
+                        temporalUpscaler->release(*renderTargets);
+                        updateRenderSize();
+                        DebugConsole::command.response = "Temporal upsampling disabled.";
+                    }
+                    else
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type bool.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "taascale")
+                {
+                    try
+                    {
+                        settings.temporalScale = std::clamp(std::stof(DebugConsole::command[2]), 0.25f, 1.0f);
+                        updateRenderSize();
+                        DebugConsole::command.response = fmt::format("Set temporal upsampling scale to {:.2f}x.", settings.temporalScale);
+                    }
+                    catch (std::invalid_argument& ex)
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type float.";
+                    }
+
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "vrambudget")
+                {
+                    try
+                    {
+                        settings.vramBudget = std::max(std::stoi(DebugConsole::command[2]), 0);
+                        MemoryTracker::setVramBudget(static_cast<uint64_t>(settings.vramBudget) * 1024 * 1024);
+                        DebugConsole::command.response = settings.vramBudget > 0
+                            ? fmt::format("Set VRAM budget to {} MB.", settings.vramBudget)
+                            : std::string("Disabled VRAM budget.");
+                    }
+                    catch (std::invalid_argument& ex)
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type int.";
+                    }
+
                     DebugConsole::command.processed = true;
                 }
             }
@@ -383,16 +866,48 @@ void Game::processInput(float deltaTime)
                         DebugConsole::command.response = "Invalid argument: must be of type int.";
                     }
 
+                    DebugConsole::command.processed = true;
+                }
+                else if (DebugConsole::command[1] == "postprocess")
+                {
+                    auto effect = postProcessFromString(DebugConsole::command[2]);
+                    if (!effect)
+                    {
+                        DebugConsole::command.response = fmt::format("Unknown effect \"{}\".", DebugConsole::command[2]);
+                    }
+                    else if (DebugConsole::command[3] == "true" || DebugConsole::command[3] == "on")
+                    {
+                        postProcessChain->enabled |= effect.value();
+                        DebugConsole::command.response = fmt::format("Enabled {}.", DebugConsole::command[2]);
+                    }
+                    else if (DebugConsole::command[3] == "false" || DebugConsole::command[3] == "off")
+                    {
+                        postProcessChain->enabled &= ~effect.value();
+                        DebugConsole::command.response = fmt::format("Disabled {}.", DebugConsole::command[2]);
+                    }
+                    else
+                    {
+                        DebugConsole::command.response = "Invalid argument: must be of type bool.";
+                    }
+
                     DebugConsole::command.processed = true;
                 }
             }
         }
     }
 
-    // Close window on Escape.
-    Keyboard::addKeyBinding([this]() {
-        glfwSetWindowShouldClose(window, true);
-    }, GLFW_KEY_ESCAPE, GLFW_RELEASE);
+    statsViewer->processInput();
+}
+
+void Game::tick(int64_t time, float timeStep)
+{
+    PROFILE_SCOPE("Game::tick");
+    previousCameraPosition = camera->position;
+    previousCameraOrientation = { camera->yaw, camera->pitch };
+
+    inputRecorder->beginTick(time);
+    handleInputEvents(time);
+    Keyboard::update();
 
     if (debugConsole->hidden)
     {
@@ -430,34 +945,275 @@ void Game::processInput(float deltaTime)
             camera->movementSpeed = camera->DEFAULT_MOVEMENT_SPEED;
         }
 
-        camera->processKeyboard(cameraDirection, deltaTime);
+        camera->processKeyboard(cameraDirection, timeStep);
     }
 
-    statsViewer->processInput();
+    tickCameraPosition = camera->position;
+    tickCameraOrientation = { camera->yaw, camera->pitch };
+}
+
+void Game::handleInputEvents(int64_t time)
+{
+    PROFILE_SCOPE("Game::handleInputEvents");
+    // The camera turns by the distance from the last cursor position, so of consecutive cursor movements only the
+    // last needs handling. Other events keep their order relative to it.
+    InputEvent event;
+    std::optional<InputEvent> cursorPos;
+    while (pendingInputEvent || inputQueue->pop(event))
+    {
+        if (pendingInputEvent)
+        {
+            event = pendingInputEvent.value();
+            pendingInputEvent.reset();
+        }
+        // Events after the end of this tick belong to a later one.
+        if (event.time > time)
+        {
+            pendingInputEvent = event;
+            break;
+        }
+
+        if (event.type == InputEvent::Type::CursorPos)
+        {
+            cursorPos = event;
+            continue;
+        }
+        if (cursorPos)
+        {
+            inputRecorder->onEvent(cursorPos.value());
+            cursorPos.reset();
+        }
+        inputRecorder->onEvent(event);
+    }
+    if (cursorPos)
+    {
+        inputRecorder->onEvent(cursorPos.value());
+    }
+
+    if (uint64_t dropped = inputQueue->takeDropped())
+    {
+        LOG_WARN("Dropped {} input events because the queue was full.", dropped);
+    }
+}
+
+void Game::onKey(int key, int, int action, int mods)
+{
+    Keyboard::onKeyEvent(key, action, mods);
+}
+
+void Game::onChar(unsigned int codePoint)
+{
+    Keyboard::onCharEvent(codePoint);
+}
+
+void Game::onCursorPos(double xPos, double yPos)
+{
+    if (debugConsole->hidden)
+    {
+        camera->processMouseMovement(xPos, yPos);
+    }
+}
+
+void Game::onScroll(double, double yOffset)
+{
+    if (debugConsole->hidden)
+    {
+        camera->processMouseScroll(yOffset);
+    }
 }
 
 void Game::update()
 {
+    PROFILE_SCOPE("Game::update");
+    bool newTimings = gpuProfiler->poll();
+    if (newTimings && settings.dynamicResolution)
+    {
+        // Resolving MSAA is part of the cost of the scene's resolution.
+        dynamicResolution->update(gpuProfiler->getMilliseconds("scene") + gpuProfiler->getMilliseconds("resolve"));
+        updateRenderSize();
+    }
+
+    if (calibrator)
+    {
+        // Every preset flies the same path, so they render the same views.
+        calibrationPath.apply(*camera, calibrator->getProgress() * calibrationPath.getDuration());
+        if (calibrator->addFrame(newTimings, gpuProfiler->getFrameMilliseconds()))
+        {
+            if (calibrator->isFinished())
+            {
+                finishCalibration();
+            }
+            else
+            {
+                applyPreset(calibrator->getPreset());
+            }
+        }
+    }
+
     debugConsole->update();
-    statsViewer->update();
+    statsViewer->update(gpuProfiler->getFrameMilliseconds());
 }
 
 void Game::draw()
 {
-    // First pass
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    PROFILE_SCOPE("Game::draw");
+    renderTargets->beginFrame(nowSeconds());
+
+    // With MSAA the scene is drawn into a multisample target and resolved into the scene texture afterwards.
+    // Temporal upsampling already anti-aliases the scene and needs a velocity buffer, so it replaces MSAA.
+    bool temporal = settings.temporalUpsampling;
+    int samples = temporal ? 0 : antiAliasingSamples(settings.antiAliasing);
+    const RenderTarget& sceneTarget = renderTargets->getTarget("scene", {
+        .size = renderTargetSize,
+        .colorFormat = GL_RGB8,
+        .depthFormat = samples > 0 ? GL_NONE : GL_DEPTH24_STENCIL8,
+        .velocityFormat = temporal ? GL_RG16F : GL_NONE
+    });
+    const RenderTarget* multisampleTarget = nullptr;
+    if (samples > 0)
+    {
+        multisampleTarget = &renderTargets->getTarget("sceneMultisample", {
+            .size = renderTargetSize,
+            .colorFormat = GL_RGB8,
+            .depthFormat = GL_DEPTH24_STENCIL8,
+            .samples = samples
+        });
+    }
+
+    // The scene is drawn into the bottom-left corner of the target. The target can be smaller than the render size
+    // for a moment while a window resize is being debounced.
+    glm::ivec2 viewportSize = glm::min(renderSize, sceneTarget.desc.size);
+    if (multisampleTarget)
+    {
+        viewportSize = glm::min(viewportSize, multisampleTarget->desc.size);
+    }
 
     glm::mat4 projection = glm::perspective(glm::radians(camera->fov),
                                             static_cast<float>(renderSize.x) / static_cast<float>(renderSize.y), 0.1f, 100.0f);
     glm::mat4 view = camera->getViewMatrix();
+    viewProjection = projection * view;
+    jitteredViewProjection = viewProjection;
+    if (temporal)
+    {
+        temporalUpscaler->beginFrame(viewportSize, windowSize);
+        jitteredViewProjection = temporalUpscaler->jitter(projection) * view;
+    }
+
+    if (headlessContext)
+    {
+        // There is no default framebuffer to present to.
+        backbuffer = renderTargets->getTarget("backbuffer", { .size = windowSize, .colorFormat = GL_RGBA8 });
+    }
+    else
+    {
+        backbuffer.desc.size = windowSize;
+    }
+
+    renderGraph->reset();
+    RenderResource scene = renderGraph->importTarget("scene", sceneTarget);
+    RenderResource screen = renderGraph->importTarget("backbuffer", backbuffer);
+
+    // Scene pass
+    bool resolve = multisampleTarget != nullptr;
+    RenderResource sceneOutput = scene;
+    if (resolve)
+    {
+        sceneOutput = renderGraph->importTarget("sceneMultisample", *multisampleTarget);
+    }
+    renderGraph->addPass("scene", {}, { sceneOutput }, [this, sceneOutput, viewportSize, temporal](const RenderGraph& graph) {
+        glBindFramebuffer(GL_FRAMEBUFFER, graph.getTarget(sceneOutput).fbo);
+        glViewport(0, 0, viewportSize.x, viewportSize.y);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_CULL_FACE);
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (temporal)
+        {
+            const GLfloat noMotion[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            glClearBufferfv(GL_COLOR, 1, noMotion);
+        }
+        drawScene();
+
+        // Leave the state the full-screen passes expect.
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        glDisable(GL_DEPTH_TEST);
+    });
+
+    // Resolve MSAA.
+    if (resolve)
+    {
+        renderGraph->addPass("resolve", { sceneOutput }, { scene }, [this, sceneOutput, scene, viewportSize](const RenderGraph& graph) {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, graph.getTarget(sceneOutput).fbo);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, graph.getTarget(scene).fbo);
+            glBlitFramebuffer(0, 0, viewportSize.x, viewportSize.y, 0, 0, viewportSize.x, viewportSize.y,
+                              GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        });
+    }
+
+    // Temporal upsampling to window resolution. Post-processing then runs on the upsampled image.
+    RenderResource postInput = scene;
+    glm::ivec2 postViewport = viewportSize;
+    if (temporal)
+    {
+        postInput = temporalUpscaler->addPass(*renderGraph, *renderTargets, scene, windowSize);
+        postViewport = temporalUpscaler->getOutputViewport();
+    }
+
+    // Post-processing
+    RenderResource postOutput = postProcessChain->addPasses(*renderGraph, postInput, postViewport);
 
+    // Second pass
+    renderGraph->addPass("present", { postOutput }, { screen }, [this, postOutput, screen, postViewport](const RenderGraph& graph) {
+        const RenderTarget& source = graph.getTarget(postOutput);
+        glBindFramebuffer(GL_FRAMEBUFFER, graph.getTarget(screen).fbo);
+        glViewport(0, 0, windowSize.x, windowSize.y);
+        screenShader->use();
+        glm::vec2 targetSize = glm::vec2(source.desc.size);
+        screenShader->setVector2f("UvScale", glm::vec2(postViewport) / targetSize);
+        screenShader->setVector2f("UvMax", (glm::vec2(postViewport) - 0.5f) / targetSize);
+        glBindVertexArray(quadVAO);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, source.colorTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+    });
+
+    // Overlays
+    renderGraph->addPass("overlay", {}, { screen }, [this](const RenderGraph&) {
+        statsViewer->render(VERSION.toLongString(), windowSize, renderSize, renderScale, *gpuProfiler);
+        debugConsole->render(glm::vec3(1.0f));
+        GpuProfiler::Scope scope(*gpuProfiler, "text");
+        textRenderer->flush();
+    });
+
+    renderGraph->compile();
+    renderGraph->execute();
+    previousViewProjection = viewProjection;
+    GlCounters::endFrame();
+    GlDebug::drain();
+
+    renderTargets->endFrame();
+
+    // An offscreen context has nothing to swap; the benchmark waits for the GPU itself, outside the CPU time.
+    if (window)
+    {
+        glfwSwapBuffers(window);
+    }
+}
+
+void Game::drawScene()
+{
+    PROFILE_SCOPE("Game::drawScene");
     glm::mat4 model;
 
+    // Nothing in the scene moves yet, so the previous model matrix of every object is its current one.
+    auto setModel = [](const std::shared_ptr<Shader>& shader, const glm::mat4& matrix) {
+        shader->setMatrix4("Model", matrix);
+        shader->setMatrix4("PrevModel", matrix);
+        shader->setMatrix3("Normal", glm::mat3(glm::transpose(glm::inverse(matrix))));
+    };
+
     // Light
+    gpuProfiler->begin("lamps");
     lampShader->use();
 
     glm::vec3 pointLightPositions[] = {
@@ -468,18 +1224,22 @@ void Game::draw()
     };
 
     // Light Source
-    lampShader->setMatrix4("ViewProjection", projection * view);
-    for (auto pos : pointLightPositions)
+    lampShader->setMatrix4("ViewProjection", jitteredViewProjection);
+    lampShader->setMatrix4("UnjitteredViewProjection", viewProjection);
+    lampShader->setMatrix4("PrevViewProjection", previousViewProjection);
+    for (int i = 0; i < settings.pointLights; ++i)
     {
+        const glm::vec3& pos = pointLightPositions[i];
         model = glm::mat4(1.0f);
         model = glm::translate(model, pos);
         model = glm::scale(model, glm::vec3(0.2f, 0.2f, 0.2f));
-        lampShader->setMatrix4("Model", model);
-        lampShader->setMatrix3("Normal", glm::mat3(glm::transpose(glm::inverse(model))));
+        setModel(lampShader, model);
         cube->render(lampShader, lampMaterialIndex);
     }
 
     // Meshes
+    gpuProfiler->end();
+    gpuProfiler->begin("meshes");
     meshShader->use();
 
     glm::vec3 cubePositions[] = {
@@ -496,7 +1256,9 @@ void Game::draw()
     };
 
     // Cube
-    meshShader->setMatrix4("ViewProjection", projection * view);
+    meshShader->setMatrix4("ViewProjection", jitteredViewProjection);
+    meshShader->setMatrix4("UnjitteredViewProjection", viewProjection);
+    meshShader->setMatrix4("PrevViewProjection", previousViewProjection);
     meshShader->setVector3f("ViewPos", camera->position);
 
     meshShader->setVector3f("DirLight.direction", -0.2f, -1.0f, -0.3f);
@@ -535,6 +1297,7 @@ void Game::draw()
     meshShader->setFloat("PointLight[3].constant", 1.0f);
     meshShader->setFloat("PointLight[3].linear", 0.09);
     meshShader->setFloat("PointLight[3].quadratic", 0.032);
+    meshShader->setInteger("PointLightCount", settings.pointLights);
     // spotLight
     meshShader->setVector3f("SpotLight.position", camera->position);
     meshShader->setVector3f("SpotLight.direction", camera->front);
@@ -553,8 +1316,7 @@ void Game::draw()
         model = glm::translate(model, cubePositions[i]);
         float angle = 20.0f * i;
         model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-        meshShader->setMatrix4("Model", model);
-        meshShader->setMatrix3("Normal", glm::mat3(glm::transpose(glm::inverse(model))));
+        setModel(meshShader, model);
         cube->render(meshShader);
     }
 
@@ -562,43 +1324,114 @@ void Game::draw()
     model = glm::mat4(1.0f);
     model = glm::translate(model, glm::vec3(0.0f, -1.75f, -3.0f));
     model = glm::scale(model, glm::vec3(0.2f, 0.2f, 0.2f));
-    meshShader->setMatrix4("Model", model);
-    meshShader->setMatrix3("Normal", glm::mat3(glm::transpose(glm::inverse(model))));
+    setModel(meshShader, model);
     nanosuit->render(meshShader);
+    gpuProfiler->end();
+}
 
-    // Second pass
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glDisable(GL_DEPTH_TEST);
-    screenShader->use();
-//    screenShader->setInteger("PostProcess.operation", PostProcess::Blur);
-//    float offset = 1.0f / 300.0f;
-//    glm::vec2 offsets[9] = {
-//        { -offset,  offset  },  // top-left
-//        {  0.0f,    offset  },  // top-center
-//        {  offset,  offset  },  // top-right
-//        { -offset,  0.0f    },  // center-left
-//        {  0.0f,    0.0f    },  // center-center
-//        {  offset,  0.0f    },  // center - right
-//        { -offset, -offset  },  // bottom-left
-//        {  0.0f,   -offset  },  // bottom-center
-//        {  offset, -offset  }   // bottom-right
-//    };
-//    screenShader->setVector2Array("PostProcess.offsets", 9, offsets);
-//    float blurKernel[9] = {
-//        1.0 / 16, 2.0 / 16, 1.0 / 16,
-//        2.0 / 16, 4.0 / 16, 2.0 / 16,
-//        1.0 / 16, 2.0 / 16, 1.0 / 16
-//    };
-//    screenShader->setFloatArray("PostProcess.kernel", 9, blurKernel);
-    glBindVertexArray(quadVAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texColorBuffer);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, windowSize.x, windowSize.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+void Game::applyAntiAliasing()
+{
+    int samples = antiAliasingSamples(settings.antiAliasing);
+    if (samples > maxSamples)
+    {
+        AntiAliasing fallback = maxSamples >= 4 ? AntiAliasing::Msaa4 : maxSamples >= 2 ? AntiAliasing::Msaa2 : AntiAliasing::Fxaa;
+        LOG_WARN("{}x MSAA is not supported by this device (at most {}x), using {}.", samples, maxSamples,
+                 antiAliasingToString(fallback));
+        settings.antiAliasing = fallback;
+    }
+
+    if (settings.antiAliasing == AntiAliasing::Fxaa)
+    {
+        postProcessChain->enabled |= PostProcess::Fxaa;
+    }
+    else
+    {
+        postProcessChain->enabled &= ~PostProcess::Fxaa;
+    }
+
+    if (settings.temporalUpsampling || antiAliasingSamples(settings.antiAliasing) == 0)
+    {
+        renderTargets->releaseTarget("sceneMultisample");
+    }
+}
+
+void Game::updateRenderSize()
+{
+    // With dynamic resolution the target is allocated at the largest scale and only the viewport changes, so
+    // adjusting the scale never reallocates the target.
+    float targetScale = settings.superSampling;
+    renderScale = settings.superSampling;
+    if (settings.temporalUpsampling)
+    {
+        targetScale = settings.temporalScale;
+        renderScale = settings.temporalScale;
+    }
+    if (settings.dynamicResolution)
+    {
+        targetScale = dynamicResolution->maxScale;
+        renderScale = dynamicResolution->getScale();
+    }
+
+    renderTargetSize = glm::max(glm::ivec2(glm::vec2(windowSize) * targetScale), glm::ivec2(1));
+    renderSize = glm::clamp(glm::ivec2(glm::vec2(windowSize) * renderScale), glm::ivec2(1), renderTargetSize);
+}
+
+void Game::startCalibration()
+{
+    if (auto result = calibrationPath.loadFromFile("assets/benchmarks/default.path"))
+    {
+        LOG_ERROR("Cannot calibrate graphics settings: {}", result.value());
+        return;
+    }
 
-    statsViewer->render(VERSION.toLongString(), windowSize, renderSize, settings.superSampling);
-    debugConsole->render(glm::vec3(1.0f));
+    // Presets are compared at their own resolution and anti-aliasing, so nothing may adjust them meanwhile.
+    calibrationDynamicResolution = settings.dynamicResolution;
+    calibrationTemporalUpsampling = settings.temporalUpsampling;
+    calibrationPosition = camera->position;
+    calibrationOrientation = { camera->yaw, camera->pitch };
+    settings.dynamicResolution = false;
+    if (settings.temporalUpsampling)
+    {
+        settings.temporalUpsampling = false;
+        temporalUpscaler->release(*renderTargets);
+    }
+
+    calibrator = std::make_unique<Calibrator>(settings.calibrationFrameTime);
+    LOG_INFO("Calibrating graphics settings for a GPU frame time of {:.1f} ms...", settings.calibrationFrameTime);
+    applyPreset(calibrator->getPreset());
+}
+
+void Game::finishCalibration()
+{
+    const GraphicsPreset& preset = calibrator->getPreset();
+    LOG_INFO("Calibrated graphics settings: {} ({}).", preset.name, calibrator->getReport());
+    applyPreset(preset);
+    calibrator.reset();
+
+    settings.dynamicResolution = calibrationDynamicResolution;
+    if (settings.dynamicResolution)
+    {
+        dynamicResolution->reset(renderScale);
+    }
+    settings.temporalUpsampling = calibrationTemporalUpsampling;
+    if (settings.temporalUpsampling)
+    {
+        temporalUpscaler->invalidate();
+        applyAntiAliasing();
+    }
+    updateRenderSize();
+    camera->position = calibrationPosition;
+    camera->setOrientation(calibrationOrientation.x, calibrationOrientation.y);
 
-    glfwSwapBuffers(window);
+    settings.calibrated = true;
+    saveSettings(settings, SETTINGS_PATH);
+}
+
+void Game::applyPreset(const GraphicsPreset& preset)
+{
+    settings.superSampling = preset.superSampling;
+    settings.antiAliasing = preset.antiAliasing;
+    settings.pointLights = preset.pointLights;
+    applyAntiAliasing();
+    updateRenderSize();
 }
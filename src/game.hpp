@@ -4,14 +4,29 @@
 #include "camera.hpp"
 #include "version.hpp"
 #include "settings.hpp"
+#include "debug/benchmark.hpp"
 #include "debug/debugConsole.hpp"
+#include "debug/metricsExporter.hpp"
 #include "debug/statsViewer.hpp"
+#include "input/inputQueue.hpp"
+#include "input/inputRecorder.hpp"
+#include "renderer/calibrator.hpp"
+#include "renderer/dynamicResolution.hpp"
+#include "renderer/gpuProfiler.hpp"
+#include "renderer/headlessContext.hpp"
 #include "renderer/model.hpp"
+#include "renderer/postProcess.hpp"
+#include "renderer/renderGraph.hpp"
+#include "renderer/renderTarget.hpp"
 #include "renderer/shader.hpp"
+#include "renderer/temporalUpscaler.hpp"
 #include <GLFW/glfw3.h>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 class Game
 {
@@ -21,37 +36,97 @@ public:
     ~Game();
 
     std::optional<std::string> run();
+    // @brief Flies the camera along a path offscreen and measures every frame.
+    std::optional<std::string> runBenchmark(const BenchmarkOptions& options, BenchmarkResults& results);
 
 private:
     const char* TITLE = "kumigame";
     const Version VERSION = Version(VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH);
     const char* SETTINGS_PATH = "settings.toml";
+    const char* PROFILE_PATH = "logs/profile.json";
+    const char* INPUT_PATH = "logs/input.rec";
     Settings settings;
     GLFWwindow* window = nullptr;
+    // Replaces the window when benchmarking. Declared early so the context outlives the GL objects of other members.
+    std::unique_ptr<HeadlessContext> headlessContext;
+    std::optional<BenchmarkOptions> benchmark;
     glm::ivec2 windowPos{};
     glm::ivec2 windowSize{};
     glm::ivec2 renderSize{};
+    glm::ivec2 renderTargetSize{};
+    float renderScale = 1.0f;
+    glm::mat4 viewProjection{1.0f};
+    glm::mat4 jitteredViewProjection{1.0f};
+    glm::mat4 previousViewProjection{1.0f};
+    int maxSamples = 0;
     std::unique_ptr<Camera> camera;
+    // Time not simulated yet, less than a tick after every frame.
+    int64_t tickLag = 0;
+    // Camera positions and yaw and pitch after the last two ticks, rendered interpolated.
+    glm::vec3 previousCameraPosition{};
+    glm::vec3 tickCameraPosition{};
+    glm::vec2 previousCameraOrientation{};
+    glm::vec2 tickCameraOrientation{};
+    std::unique_ptr<InputQueue> inputQueue;
+    // The first event popped that belongs to a later tick.
+    std::optional<InputEvent> pendingInputEvent;
+    std::unique_ptr<InputRecorder> inputRecorder;
+    bool replayingInput = false;
     std::shared_ptr<TextRenderer> textRenderer;
     std::unique_ptr<DebugConsole> debugConsole;
     std::unique_ptr<StatsViewer> statsViewer;
     std::shared_ptr<Shader> screenShader;
     std::shared_ptr<Shader> meshShader;
     std::shared_ptr<Shader> lampShader;
+    std::shared_ptr<Shader> graphShader;
     std::unique_ptr<Model> nanosuit;
     std::unique_ptr<Model> cube;
+    std::unique_ptr<RenderTargetManager> renderTargets;
+    std::unique_ptr<RenderGraph> renderGraph;
+    RenderTarget backbuffer;
+    std::unique_ptr<GpuProfiler> gpuProfiler;
+    std::unique_ptr<PostProcessChain> postProcessChain;
+    std::unique_ptr<TemporalUpscaler> temporalUpscaler;
+    std::unique_ptr<DynamicResolution> dynamicResolution;
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    std::unique_ptr<Calibrator> calibrator;
+    CameraPath calibrationPath;
+    // Restored when the calibration finishes.
+    bool calibrationDynamicResolution = false;
+    bool calibrationTemporalUpsampling = false;
+    glm::vec3 calibrationPosition{};
+    glm::vec2 calibrationOrientation{};
     size_t lampMaterialIndex = 0;
-    unsigned int fbo;
-    unsigned int rbo;
-    unsigned int texColorBuffer;
     unsigned int quadVAO;
     unsigned int quadVBO;
+    std::vector<std::pair<std::string, double>> loadTimes;
 
     std::optional<std::string> init();
+    std::optional<std::string> createWindow();
+    std::optional<std::string> createOffscreenContext();
     std::optional<std::string> loadAssets();
-    void processInput(float deltaTime);
+    // @brief Polls and handles input and console commands. A replay replaces the frame time with the recorded one.
+    void processInput(int64_t& frameTime);
+    // @brief Passes the events queued by the GLFW callbacks up to the given time to the handlers below, through the
+    // input recorder.
+    void handleInputEvents(int64_t time);
+    void onKey(int key, int scancode, int action, int mods);
+    void onChar(unsigned int codePoint);
+    void onCursorPos(double xPos, double yPos);
+    void onScroll(double xOffset, double yOffset);
+    // @brief Advances the simulation by a fixed time step, in seconds, handling the input that arrived before the
+    // tick ends at the given nowNanoseconds() time.
+    void tick(int64_t time, float timeStep);
     void update();
     void draw();
+    void drawScene();
+    void updateRenderSize();
+    void applyAntiAliasing();
+    // @brief Flies the camera along the benchmark path at every graphics preset and keeps the best one that meets
+    // the calibration target.
+    void startCalibration();
+    void finishCalibration();
+    void applyPreset(const GraphicsPreset& preset);
 };
 
 #endif //KUMIGAME_GAME_HPP
@@ -0,0 +1,58 @@
+#include "inputQueue.hpp"
+#include "../util/clock.hpp"
+
+void InputQueue::pushKey(int key, int scancode, int action, int mods)
+{
+    InputEvent event{};
+    event.type = InputEvent::Type::Key;
+    event.key = key;
+    event.scancode = scancode;
+    event.action = action;
+    event.mods = mods;
+    push(event);
+}
+
+void InputQueue::pushChar(unsigned int codePoint)
+{
+    InputEvent event{};
+    event.type = InputEvent::Type::Char;
+    event.codePoint = codePoint;
+    push(event);
+}
+
+void InputQueue::pushCursorPos(double xPos, double yPos)
+{
+    InputEvent event{};
+    event.type = InputEvent::Type::CursorPos;
+    event.x = xPos;
+    event.y = yPos;
+    push(event);
+}
+
+void InputQueue::pushScroll(double xOffset, double yOffset)
+{
+    InputEvent event{};
+    event.type = InputEvent::Type::Scroll;
+    event.x = xOffset;
+    event.y = yOffset;
+    push(event);
+}
+
+bool InputQueue::pop(InputEvent& event)
+{
+    return queue.tryPop(event);
+}
+
+uint64_t InputQueue::takeDropped()
+{
+    return dropped.exchange(0, std::memory_order_relaxed);
+}
+
+void InputQueue::push(InputEvent event)
+{
+    event.time = nowNanoseconds();
+    if (!queue.tryPush(event))
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
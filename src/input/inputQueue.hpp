@@ -0,0 +1,63 @@
+#ifndef KUMIGAME_INPUT_INPUT_QUEUE_HPP
+#define KUMIGAME_INPUT_INPUT_QUEUE_HPP
+
+#include "../util/mpscQueue.hpp"
+#include <atomic>
+#include <cstdint>
+
+struct InputEvent
+{
+    enum class Type : uint8_t
+    {
+        Key,
+        Char,
+        CursorPos,
+        Scroll
+    };
+
+    Type type;
+    // nowNanoseconds() when the event arrived
+    int64_t time;
+    // Key
+    int key;
+    int scancode;
+    int action;
+    int mods;
+    // Char
+    unsigned int codePoint;
+    // CursorPos and Scroll
+    double x;
+    double y;
+};
+
+/**
+ * @brief Input events in order of arrival, each with the time it arrived.
+ *
+ * The GLFW callbacks only push events, so polling events does no game work however many events a fast mouse sends.
+ * The game pops them once per frame and handles them, merging consecutive cursor movements into the last one. Pushing
+ * is lock-free and safe from any thread.
+ */
+class InputQueue
+{
+public:
+    void pushKey(int key, int scancode, int action, int mods);
+    void pushChar(unsigned int codePoint);
+    void pushCursorPos(double xPos, double yPos);
+    void pushScroll(double xOffset, double yOffset);
+
+    // @brief Pops the oldest event. Consumer thread only.
+    bool pop(InputEvent& event);
+    // @brief Returns the number of events lost because the queue was full since the last call.
+    uint64_t takeDropped();
+
+private:
+    // A second of 1000 Hz mouse input.
+    static const size_t CAPACITY = 1024;
+
+    MpscQueue<InputEvent, CAPACITY> queue;
+    std::atomic<uint64_t> dropped = 0;
+
+    void push(InputEvent event);
+};
+
+#endif //KUMIGAME_INPUT_INPUT_QUEUE_HPP
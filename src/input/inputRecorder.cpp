@@ -0,0 +1,388 @@
+#include "inputRecorder.hpp"
+#include "keyboard.hpp"
+#include "../debug/log.hpp"
+#include "../util/clock.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+// Files are written in the byte order of the machine; every platform the game runs on is little-endian.
+//
+// Header: magic (u32), version (u16), camera position (3 x f32), yaw, pitch, fov, last cursor x and y (f32),
+//         first mouse (u8), bitmask of the keys held when recording started, from GLFW_KEY_SPACE to GLFW_KEY_LAST.
+// Record: type (u8), nanoseconds since the recording started (i64), then by type:
+//         Frame: frame time in nanoseconds (i64)
+//         Key: key (i16), scancode (i16), action (u8), mods (u8)
+//         Char: code point (u32)
+//         CursorPos, Scroll: x and y (2 x f64)
+//         Tick: nothing; the events up to the next tick or frame record belong to the tick
+
+namespace
+{
+    const size_t KEY_MASK_SIZE = (GLFW_KEY_LAST - GLFW_KEY_SPACE + 1 + 7) / 8;
+}
+
+InputRecorder::InputRecorder(Handlers handlers)
+    : handlers(std::move(handlers))
+{
+}
+
+InputRecorder::~InputRecorder()
+{
+    stop();
+}
+
+void InputRecorder::onEvent(const InputEvent& event)
+{
+    if (replaying)
+    {
+        return;
+    }
+
+    switch (event.type)
+    {
+        case InputEvent::Type::Key:
+            if (recording)
+            {
+                writeRecord(Record::Key, event.time);
+                write(static_cast<int16_t>(event.key));
+                write(static_cast<int16_t>(event.scancode));
+                write(static_cast<uint8_t>(event.action));
+                write(static_cast<uint8_t>(event.mods));
+            }
+            handlers.key(event.key, event.scancode, event.action, event.mods);
+            break;
+        case InputEvent::Type::Char:
+            if (recording)
+            {
+                writeRecord(Record::Char, event.time);
+                write(static_cast<uint32_t>(event.codePoint));
+            }
+            handlers.character(event.codePoint);
+            break;
+        case InputEvent::Type::CursorPos:
+            if (recording)
+            {
+                writeRecord(Record::CursorPos, event.time);
+                write(event.x);
+                write(event.y);
+            }
+            handlers.cursorPos(event.x, event.y);
+            break;
+        case InputEvent::Type::Scroll:
+            if (recording)
+            {
+                writeRecord(Record::Scroll, event.time);
+                write(event.x);
+                write(event.y);
+            }
+            handlers.scroll(event.x, event.y);
+            break;
+    }
+}
+
+std::optional<std::string> InputRecorder::startRecording(const std::string& path, const Camera& camera)
+{
+    if (recording || replaying)
+    {
+        return "Already recording or replaying input.";
+    }
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        return fmt::format("Could not open \"{}\" for writing.", path);
+    }
+
+    write(MAGIC);
+    write(VERSION);
+    write(camera.position.x);
+    write(camera.position.y);
+    write(camera.position.z);
+    write(camera.yaw);
+    write(camera.pitch);
+    write(camera.fov);
+    write(camera.lastX);
+    write(camera.lastY);
+    write(static_cast<uint8_t>(camera.firstMouse));
+
+    // Keys held now produce no press event, so their state is stored up front.
+    std::array<uint8_t, KEY_MASK_SIZE> keyMask{};
+    for (int key = FIRST_KEY; key <= GLFW_KEY_LAST; ++key)
+    {
+        if (Keyboard::pressed(key))
+        {
+            keyMask[(key - FIRST_KEY) / 8] |= static_cast<uint8_t>(1 << ((key - FIRST_KEY) % 8));
+        }
+    }
+    file.write(reinterpret_cast<const char*>(keyMask.data()), keyMask.size());
+
+    startTime = nowNanoseconds();
+    recording = true;
+    LOG_INFO("Recording input to \"{}\".", path);
+    return {};
+}
+
+std::optional<std::string> InputRecorder::startReplay(const std::string& path, Camera& camera)
+{
+    if (recording || replaying)
+    {
+        return "Already recording or replaying input.";
+    }
+
+    std::ifstream input(path, std::ios::binary);
+    if (!input)
+    {
+        return fmt::format("Could not open \"{}\".", path);
+    }
+    replay.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    replayPosition = 0;
+
+    uint32_t magic = 0;
+    uint16_t version = 0;
+    if (!read(magic) || !read(version) || magic != MAGIC)
+    {
+        replay.clear();
+        return fmt::format("\"{}\" is not an input recording.", path);
+    }
+    if (version != VERSION)
+    {
+        replay.clear();
+        return fmt::format("\"{}\" is version {} of the format, expected {}.", path, version, VERSION);
+    }
+
+    glm::vec3 position;
+    float yaw, pitch, fov, lastX, lastY;
+    uint8_t firstMouse;
+    std::array<uint8_t, KEY_MASK_SIZE> keyMask{};
+    if (!read(position.x) || !read(position.y) || !read(position.z) || !read(yaw) || !read(pitch) || !read(fov) ||
+        !read(lastX) || !read(lastY) || !read(firstMouse) || !read(keyMask))
+    {
+        replay.clear();
+        return fmt::format("\"{}\" is truncated.", path);
+    }
+    size_t firstRecord = replayPosition;
+
+    // Check the records before changing any state, so a damaged file cannot stop a replay halfway.
+    replayFrames = 0;
+    while (replayPosition < replay.size())
+    {
+        auto record = static_cast<Record>(replay[replayPosition]);
+        if (record > Record::Tick)
+        {
+            replay.clear();
+            return fmt::format("\"{}\" has an unknown record at byte {}.", path, replayPosition);
+        }
+        replayPosition += 1 + sizeof(int64_t) + payloadSize(record);
+        if (replayPosition > replay.size())
+        {
+            replay.clear();
+            return fmt::format("\"{}\" is truncated.", path);
+        }
+        replayFrames += record == Record::Frame;
+    }
+    if (replayFrames == 0)
+    {
+        replay.clear();
+        return fmt::format("\"{}\" has no frames.", path);
+    }
+
+    camera.position = position;
+    camera.setOrientation(yaw, pitch);
+    camera.fov = fov;
+    camera.lastX = lastX;
+    camera.lastY = lastY;
+    camera.firstMouse = firstMouse != 0;
+    for (int key = FIRST_KEY; key <= GLFW_KEY_LAST; ++key)
+    {
+        bool pressed = keyMask[(key - FIRST_KEY) / 8] & (1 << ((key - FIRST_KEY) % 8));
+        Keyboard::set(key, pressed ? GLFW_PRESS : GLFW_RELEASE);
+    }
+
+    replayPosition = firstRecord;
+    replayedFrames = 0;
+    replaying = true;
+    LOG_INFO("Replaying {} frames of input from \"{}\".", replayFrames, path);
+    return {};
+}
+
+void InputRecorder::stop()
+{
+    if (recording)
+    {
+        recording = false;
+        file.close();
+        if (!file)
+        {
+            LOG_ERROR("Failed to write the input recording.");
+        }
+        else
+        {
+            LOG_INFO("Stopped recording input.");
+        }
+    }
+    if (replaying)
+    {
+        replaying = false;
+        replay.clear();
+        replay.shrink_to_fit();
+        LOG_INFO("Stopped replaying input after {} of {} frames.", replayedFrames, replayFrames);
+    }
+}
+
+void InputRecorder::beginFrame(int64_t& frameTime)
+{
+    if (recording)
+    {
+        writeRecord(Record::Frame, nowNanoseconds());
+        write(frameTime);
+        return;
+    }
+    if (!replaying)
+    {
+        return;
+    }
+
+    // The ticks of the last frame have been replayed.
+    if (replayPosition >= replay.size())
+    {
+        stop();
+        return;
+    }
+
+    // Records were checked when the replay started, so every read below succeeds. Each frame starts with a frame
+    // record, followed by its ticks.
+    if (static_cast<Record>(replay[replayPosition]) == Record::Frame)
+    {
+        int64_t timestamp;
+        replayPosition++;
+        read(timestamp);
+        read(frameTime);
+        replayedFrames++;
+    }
+}
+
+void InputRecorder::beginTick(int64_t time)
+{
+    if (recording)
+    {
+        writeRecord(Record::Tick, time);
+        return;
+    }
+    if (!replaying || replayPosition >= replay.size() || static_cast<Record>(replay[replayPosition]) != Record::Tick)
+    {
+        return;
+    }
+
+    int64_t timestamp;
+    replayPosition++;
+    read(timestamp);
+    while (replayPosition < replay.size() && static_cast<Record>(replay[replayPosition]) != Record::Frame &&
+           static_cast<Record>(replay[replayPosition]) != Record::Tick)
+    {
+        auto record = static_cast<Record>(replay[replayPosition]);
+        replayPosition++;
+        read(timestamp);
+        switch (record)
+        {
+            case Record::Key:
+            {
+                int16_t key, scancode;
+                uint8_t action, mods;
+                read(key);
+                read(scancode);
+                read(action);
+                read(mods);
+                handlers.key(key, scancode, action, mods);
+                break;
+            }
+            case Record::Char:
+            {
+                uint32_t codePoint;
+                read(codePoint);
+                handlers.character(codePoint);
+                break;
+            }
+            case Record::CursorPos:
+            {
+                double xPos, yPos;
+                read(xPos);
+                read(yPos);
+                handlers.cursorPos(xPos, yPos);
+                break;
+            }
+            case Record::Scroll:
+            {
+                double xOffset, yOffset;
+                read(xOffset);
+                read(yOffset);
+                handlers.scroll(xOffset, yOffset);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+bool InputRecorder::isRecording() const
+{
+    return recording;
+}
+
+bool InputRecorder::isReplaying() const
+{
+    return replaying;
+}
+
+unsigned int InputRecorder::getReplayFrames() const
+{
+    return replayFrames;
+}
+
+template<typename T>
+void InputRecorder::write(const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool InputRecorder::read(T& value)
+{
+    if (replayPosition + sizeof(T) > replay.size())
+    {
+        return false;
+    }
+    std::memcpy(&value, replay.data() + replayPosition, sizeof(T));
+    replayPosition += sizeof(T);
+    return true;
+}
+
+void InputRecorder::writeRecord(Record record, int64_t time)
+{
+    write(record);
+    // Events queued before the recording started count as arriving at its start.
+    write(std::max(time - startTime, int64_t(0)));
+}
+
+size_t InputRecorder::payloadSize(Record record)
+{
+    switch (record)
+    {
+        case Record::Frame:
+            return sizeof(int64_t);
+        case Record::Key:
+            return 2 * sizeof(int16_t) + 2 * sizeof(uint8_t);
+        case Record::Char:
+            return sizeof(uint32_t);
+        case Record::CursorPos:
+        case Record::Scroll:
+            return 2 * sizeof(double);
+        case Record::Tick:
+            return 0;
+        default:
+            return 0;
+    }
+}
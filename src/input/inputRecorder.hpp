@@ -0,0 +1,97 @@
+#ifndef KUMIGAME_INPUT_INPUT_RECORDER_HPP
+#define KUMIGAME_INPUT_INPUT_RECORDER_HPP
+
+#include "inputQueue.hpp"
+#include "../camera.hpp"
+#include <GLFW/glfw3.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Records input events to a binary file and replays them frame by frame.
+ *
+ * Live events from the input queue pass through the recorder on their way to the handlers. While recording, every
+ * event is written with the time it arrived relative to the start of the recording, and every frame with its
+ * duration, and every simulation tick. A replay restores the camera and key states of the start of the recording,
+ * substitutes the recorded duration of each frame and dispatches each recorded tick's events in the matching tick, so
+ * the session plays back tick for tick however fast the machine is. Live events are dropped while replaying.
+ *
+ * Window events, e.g. resizes, are not recorded.
+ */
+class InputRecorder
+{
+public:
+    struct Handlers
+    {
+        std::function<void(int key, int scancode, int action, int mods)> key;
+        std::function<void(unsigned int codePoint)> character;
+        std::function<void(double xPos, double yPos)> cursorPos;
+        std::function<void(double xOffset, double yOffset)> scroll;
+    };
+
+    explicit InputRecorder(Handlers handlers);
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    // @brief Records a live event if recording and passes it to its handler, unless replaying.
+    void onEvent(const InputEvent& event);
+
+    std::optional<std::string> startRecording(const std::string& path, const Camera& camera);
+    std::optional<std::string> startReplay(const std::string& path, Camera& camera);
+    // @brief Ends the recording or replay.
+    void stop();
+
+    // @brief Call at the start of every frame, before polling events. While replaying, replaces the frame time, in
+    // nanoseconds, with the recorded one.
+    void beginFrame(int64_t& frameTime);
+    // @brief Call at the start of every simulation tick, before handling its events. While replaying, dispatches the
+    // tick's events.
+    void beginTick(int64_t time);
+
+    bool isRecording() const;
+    bool isReplaying() const;
+    // @brief Returns the number of frames in the replay.
+    unsigned int getReplayFrames() const;
+
+private:
+    enum class Record : uint8_t
+    {
+        Frame,
+        Key,
+        Char,
+        CursorPos,
+        Scroll,
+        Tick
+    };
+
+    static constexpr uint32_t MAGIC = 0x504e494b; // "KINP"
+    static constexpr uint16_t VERSION = 3;
+    static constexpr int FIRST_KEY = GLFW_KEY_SPACE;
+
+    Handlers handlers;
+    std::ofstream file;
+    int64_t startTime = 0;
+    bool recording = false;
+
+    bool replaying = false;
+    std::vector<char> replay;
+    size_t replayPosition = 0;
+    unsigned int replayFrames = 0;
+    unsigned int replayedFrames = 0;
+
+    template<typename T>
+    void write(const T& value);
+    template<typename T>
+    bool read(T& value);
+    void writeRecord(Record record, int64_t time);
+    // @brief Returns the size of a record's payload after its type and timestamp.
+    static size_t payloadSize(Record record);
+};
+
+#endif //KUMIGAME_INPUT_INPUT_RECORDER_HPP
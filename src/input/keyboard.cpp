@@ -1,80 +1,148 @@
 #include "keyboard.hpp"
-#include "keyState.hpp"
+#include <algorithm>
 #include <functional>
 
-std::map<GLFW_KEY, KeyState> Keyboard::keyStates;
-std::map<GLFW_KEY, std::map<GLFW_KEY_ACTION, std::map<GLFW_KEY_MODS, std::vector<std::function<void()>>>>> Keyboard::keyCallbacks;
-std::map<unsigned int, std::vector<std::function<void()>>> Keyboard::charCallbacks;
+std::bitset<Keyboard::KEY_COUNT> Keyboard::down;
+std::bitset<Keyboard::KEY_COUNT> Keyboard::pressedSinceUpdate;
+std::bitset<Keyboard::KEY_COUNT> Keyboard::current;
+std::bitset<Keyboard::KEY_COUNT> Keyboard::releasedThisFrame;
+std::vector<Keyboard::Binding> Keyboard::bindings;
+bool Keyboard::bindingsChanged = false;
+std::vector<uint32_t> Keyboard::offsets;
+std::vector<std::function<void()>> Keyboard::callbacks;
+std::vector<std::function<void(unsigned int)>> Keyboard::charCallbacks;
 
 void Keyboard::addKeyBinding(const std::function<void()>& callback, GLFW_KEY key, GLFW_KEY_ACTION action, GLFW_KEY_MODS mods)
 {
-    keyCallbacks[key][action][mods].push_back(callback);
+    if (!isKey(key) || action < 0 || action >= ACTION_COUNT)
+    {
+        return;
+    }
+
+    auto index = static_cast<uint32_t>((key * ACTION_COUNT + action) * MODS_COUNT + (mods & (MODS_COUNT - 1)));
+    bindings.push_back({ index, callback });
+    bindingsChanged = true;
 }
 
 void Keyboard::onKeyEvent(GLFW_KEY key, GLFW_KEY_ACTION action, GLFW_KEY_MODS mods)
 {
-    for (auto& callback : keyCallbacks[key][action][mods])
+    if (!isKey(key) || action < 0 || action >= ACTION_COUNT)
+    {
+        return;
+    }
+
+    if (action == GLFW_RELEASE)
     {
-        callback();
+        down.reset(static_cast<size_t>(key));
+    }
+    else
+    {
+        down.set(static_cast<size_t>(key));
+        pressedSinceUpdate.set(static_cast<size_t>(key));
+    }
+
+    if (bindingsChanged)
+    {
+        buildBindings();
+    }
+    if (offsets.empty())
+    {
+        return;
+    }
+
+    size_t index = (key * ACTION_COUNT + action) * MODS_COUNT + (mods & (MODS_COUNT - 1));
+    // Callbacks may add bindings, which rebuilds the table on the next event, not during this loop.
+    for (uint32_t i = offsets[index]; i < offsets[index + 1]; ++i)
+    {
+        callbacks[i]();
     }
 }
 
-void Keyboard::addCharBinding(const std::function<void()>& callback, unsigned int codePoint)
+void Keyboard::addCharCallback(const std::function<void(unsigned int)>& callback)
 {
-    charCallbacks[codePoint].push_back(callback);
+    charCallbacks.push_back(callback);
 }
 
 void Keyboard::onCharEvent(unsigned int codePoint)
 {
-    for (auto& callback : charCallbacks[codePoint])
+    for (auto& callback : charCallbacks)
     {
-        callback();
+        callback(codePoint);
     }
 }
 
 void Keyboard::set(GLFW_KEY key, GLFW_KEY_STATE keyState)
 {
-    auto it = Keyboard::keyStates.find(key);
-    KeyState state;
-    if (it != Keyboard::keyStates.end())
-    {
-        state = it->second;
-        state.previousState = state.currentState;
-        state.currentState = keyState;
-    }
-    else
+    if (isKey(key))
     {
-        state = KeyState(key, keyState);
+        down.set(static_cast<size_t>(key), keyState != GLFW_RELEASE);
     }
-
-    Keyboard::keyStates[key] = state;
 }
 
 GLFW_KEY_STATE Keyboard::get(GLFW_KEY key)
 {
-    return Keyboard::keyStates[key].currentState;
+    return pressed(key) ? GLFW_PRESS : GLFW_RELEASE;
 }
 
 bool Keyboard::pressed(GLFW_KEY key)
 {
-    return Keyboard::keyStates[key].currentState == GLFW_PRESS;
+    return isKey(key) && current.test(static_cast<size_t>(key));
 }
 
 bool Keyboard::released(GLFW_KEY key)
 {
-    return Keyboard::keyStates[key].currentState == GLFW_RELEASE;
+    return !pressed(key);
 }
 
 bool Keyboard::once(GLFW_KEY key)
 {
-    KeyState keyState = Keyboard::keyStates[key];
-    return keyState.previousState == GLFW_PRESS && keyState.currentState == GLFW_RELEASE;
+    return isKey(key) && releasedThisFrame.test(static_cast<size_t>(key));
+}
+
+void Keyboard::update()
+{
+    // A key pressed and released between two updates still counts as released this frame.
+    releasedThisFrame = (current | pressedSinceUpdate) & ~down;
+    current = down;
+    pressedSinceUpdate.reset();
+}
+
+void Keyboard::poll(GLFWwindow *window)
+{
+    for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; ++key)
+    {
+        down.set(static_cast<size_t>(key), glfwGetKey(window, key) == GLFW_PRESS);
+    }
 }
 
-void Keyboard::processKeys(GLFWwindow *window)
+bool Keyboard::isKey(GLFW_KEY key)
 {
-    for (int key = 32; key <= 348; ++key)
+    // GLFW_KEY_UNKNOWN is -1.
+    return key >= 0 && key < KEY_COUNT;
+}
+
+void Keyboard::buildBindings()
+{
+    // Callbacks of one key, action and modifiers stay in the order they were added.
+    std::stable_sort(bindings.begin(), bindings.end(), [](const Binding& a, const Binding& b) {
+        return a.index < b.index;
+    });
+
+    offsets.assign(BINDING_COUNT + 1, 0);
+    for (const Binding& binding : bindings)
+    {
+        offsets[binding.index + 1]++;
+    }
+    for (size_t i = 1; i < offsets.size(); ++i)
+    {
+        offsets[i] += offsets[i - 1];
+    }
+
+    callbacks.clear();
+    callbacks.reserve(bindings.size());
+    for (const Binding& binding : bindings)
     {
-        Keyboard::set(key, glfwGetKey(window, key));
+        callbacks.push_back(binding.callback);
     }
+    bindingsChanged = false;
 }
@@ -3,17 +3,28 @@
 
 #include "keyState.hpp"
 #include <GLFW/glfw3.h>
+#include <bitset>
+#include <cstdint>
 #include <functional>
-#include <map>
 #include <vector>
 
+/**
+ * @brief Key states and key bindings, fed by the GLFW key and char callbacks.
+ *
+ * Key states are bitsets updated by key events; update() advances them once per frame, so a frame with no input costs
+ * a few word copies. Bindings are kept in a flat table indexed by key, action and modifiers, in compressed sparse row
+ * form: the callbacks of one entry are contiguous and the entry's offsets say where they are. The table is rebuilt on
+ * the first event after a binding was added, so an event is an array lookup and a loop over its callbacks, if any.
+ */
 class Keyboard
 {
 public:
     static void addKeyBinding(const std::function<void()>& callback, GLFW_KEY key, GLFW_KEY_ACTION action, GLFW_KEY_MODS mods = 0);
+    // @brief Updates the key's state and runs the callbacks bound to the event.
     static void onKeyEvent(GLFW_KEY key, GLFW_KEY_ACTION action, GLFW_KEY_MODS mods);
 
-    static void addCharBinding(const std::function<void()>& callback, unsigned int codePoint);
+    // @brief Adds a callback receiving every character typed.
+    static void addCharCallback(const std::function<void(unsigned int)>& callback);
     static void onCharEvent(unsigned int codePoint);
 
     // @brief Sets a key's current state.
@@ -26,13 +37,41 @@ public:
     static bool released(GLFW_KEY key);
     // @brief Returns whether the key was pressed then released.
     static bool once(GLFW_KEY key);
-    // @brief Gets the keys' states from GLFW.
-    static void processKeys(GLFWwindow *window);
+    // @brief Takes the key states of this frame from the events since the last call. Call once per frame after
+    // polling events.
+    static void update();
+    // @brief Sets every key's state from GLFW, for when key events were not delivered, e.g. after a replay.
+    static void poll(GLFWwindow *window);
 
 private:
-    static std::map<GLFW_KEY, KeyState> keyStates;
-    static std::map<GLFW_KEY, std::map<GLFW_KEY_ACTION, std::map<GLFW_KEY_MODS, std::vector<std::function<void()>>>>> keyCallbacks;
-    static std::map<unsigned int, std::vector<std::function<void()>>> charCallbacks;
+    static const int KEY_COUNT = GLFW_KEY_LAST + 1;
+    static const int ACTION_COUNT = 3;
+    // Shift, control, alt and super. Caps and num lock are ignored.
+    static const int MODS_COUNT = 16;
+    static const int BINDING_COUNT = KEY_COUNT * ACTION_COUNT * MODS_COUNT;
+
+    struct Binding
+    {
+        uint32_t index;
+        std::function<void()> callback;
+    };
+
+    // Updated by events.
+    static std::bitset<KEY_COUNT> down;
+    static std::bitset<KEY_COUNT> pressedSinceUpdate;
+    // Updated once per frame.
+    static std::bitset<KEY_COUNT> current;
+    static std::bitset<KEY_COUNT> releasedThisFrame;
+
+    static std::vector<Binding> bindings;
+    static bool bindingsChanged;
+    // Callbacks of binding i are callbacks[offsets[i]] up to callbacks[offsets[i + 1]].
+    static std::vector<uint32_t> offsets;
+    static std::vector<std::function<void()>> callbacks;
+    static std::vector<std::function<void(unsigned int)>> charCallbacks;
+
+    static bool isKey(GLFW_KEY key);
+    static void buildBindings();
 };
 
 #endif
@@ -1,12 +1,51 @@
+#include "debug/benchmark.hpp"
+#include "debug/flightRecorder.hpp"
 #include "debug/log.hpp"
 #include "game.hpp"
+#include <string>
+#include <vector>
 
-int main()
+// Exit codes of the benchmark: 0 when every threshold is met, 1 when one is exceeded and -1 when it cannot run.
+int runBenchmark(Game& game, const BenchmarkOptions& options)
 {
-    initLog(LOG_LEVEL_DEBUG, LOG_LEVEL_TRACE);
+    BenchmarkResults results;
+    if (auto result = game.runBenchmark(options, results))
+    {
+        LOG_CRITICAL("The benchmark could not run: {}", result.value());
+        return -1;
+    }
+
+    std::vector<std::string> failures = checkBenchmarkThresholds(options, results);
+    if (auto result = writeBenchmarkReport(options, results, failures))
+    {
+        LOG_CRITICAL("Failed to write the benchmark results: {}", result.value());
+        return -1;
+    }
+    LOG_INFO("Wrote benchmark results to \"{}\".", options.outputFile);
+
+    for (const std::string& failure : failures)
+    {
+        LOG_ERROR("Benchmark failed: {}", failure);
+    }
+    return failures.empty() ? 0 : 1;
+}
+
+int runGame(int argc, char* argv[])
+{
+    BenchmarkOptions benchmarkOptions;
+    if (auto result = parseBenchmarkOptions(argc, argv, benchmarkOptions))
+    {
+        LOG_CRITICAL("{}", result.value());
+        return -1;
+    }
 
     Game* game = new Game();
 
+    if (benchmarkOptions.enabled)
+    {
+        return runBenchmark(*game, benchmarkOptions);
+    }
+
     if (auto result = game->run())
     {
         LOG_CRITICAL("The game exited due to an error: {}", result.value());
@@ -15,3 +54,12 @@ int main()
 
     return 0;
 }
+
+int main(int argc, char* argv[])
+{
+    initLog(LOG_LEVEL_DEBUG, LOG_LEVEL_TRACE);
+    int exitCode = runGame(argc, argv);
+    FlightRecorder::shutdown();
+    shutdownLog();
+    return exitCode;
+}
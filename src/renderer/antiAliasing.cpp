@@ -0,0 +1,59 @@
+#include "antiAliasing.hpp"
+#include <string>
+
+std::optional<AntiAliasing> antiAliasingFromString(const std::string& name)
+{
+    if (name == "off" || name == "none")
+    {
+        return AntiAliasing::Off;
+    }
+    if (name == "msaa2")
+    {
+        return AntiAliasing::Msaa2;
+    }
+    if (name == "msaa4")
+    {
+        return AntiAliasing::Msaa4;
+    }
+    if (name == "msaa8")
+    {
+        return AntiAliasing::Msaa8;
+    }
+    if (name == "fxaa")
+    {
+        return AntiAliasing::Fxaa;
+    }
+    return {};
+}
+
+std::string antiAliasingToString(AntiAliasing antiAliasing)
+{
+    switch (antiAliasing)
+    {
+        case AntiAliasing::Msaa2:
+            return "msaa2";
+        case AntiAliasing::Msaa4:
+            return "msaa4";
+        case AntiAliasing::Msaa8:
+            return "msaa8";
+        case AntiAliasing::Fxaa:
+            return "fxaa";
+        default:
+            return "off";
+    }
+}
+
+int antiAliasingSamples(AntiAliasing antiAliasing)
+{
+    switch (antiAliasing)
+    {
+        case AntiAliasing::Msaa2:
+            return 2;
+        case AntiAliasing::Msaa4:
+            return 4;
+        case AntiAliasing::Msaa8:
+            return 8;
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef KUMIGAME_RENDERER_ANTI_ALIASING_HPP
+#define KUMIGAME_RENDERER_ANTI_ALIASING_HPP
+
+#include <optional>
+#include <string>
+
+enum class AntiAliasing
+{
+    Off,
+    Msaa2,
+    Msaa4,
+    Msaa8,
+    Fxaa
+};
+
+std::optional<AntiAliasing> antiAliasingFromString(const std::string& name);
+std::string antiAliasingToString(AntiAliasing antiAliasing);
+// @brief Returns the number of MSAA samples for the mode, or 0 if it does not use MSAA.
+int antiAliasingSamples(AntiAliasing antiAliasing);
+
+#endif //KUMIGAME_RENDERER_ANTI_ALIASING_HPP
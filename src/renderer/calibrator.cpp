@@ -0,0 +1,91 @@
+#include "calibrator.hpp"
+#include <fmt/format.h>
+#include <algorithm>
+
+Calibrator::Calibrator(float targetFrameTime, unsigned int warmupFrames, unsigned int sampleCount)
+    : targetFrameTime(targetFrameTime), warmupFrames(warmupFrames), sampleCount(std::max(sampleCount, 1u))
+{
+    samples.reserve(this->sampleCount);
+}
+
+const std::vector<GraphicsPreset>& Calibrator::getPresets()
+{
+    static const std::vector<GraphicsPreset> presets = {
+        { "ultra", 1.5f, AntiAliasing::Msaa4, 4 },
+        { "high", 1.0f, AntiAliasing::Msaa4, 4 },
+        { "medium", 1.0f, AntiAliasing::Fxaa, 4 },
+        { "low", 0.75f, AntiAliasing::Fxaa, 2 },
+        { "lowest", 0.5f, AntiAliasing::Off, 1 }
+    };
+    return presets;
+}
+
+bool Calibrator::addFrame(bool newTimings, float gpuMilliseconds)
+{
+    switch (state)
+    {
+        case State::Warmup:
+            if (++frames >= warmupFrames)
+            {
+                state = State::Measuring;
+            }
+            return false;
+        case State::Measuring:
+            frames++;
+            if (!newTimings)
+            {
+                return false;
+            }
+            samples.push_back(gpuMilliseconds);
+            if (samples.size() < sampleCount)
+            {
+                return false;
+            }
+            break;
+        case State::Finished:
+            return false;
+    }
+
+    auto middle = samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2);
+    std::nth_element(samples.begin(), middle, samples.end());
+    medians.push_back(*middle);
+    samples.clear();
+
+    if (*middle <= targetFrameTime || preset + 1 == getPresets().size())
+    {
+        state = State::Finished;
+    }
+    else
+    {
+        preset++;
+        frames = 0;
+        state = State::Warmup;
+    }
+    return true;
+}
+
+const GraphicsPreset& Calibrator::getPreset() const
+{
+    return getPresets()[preset];
+}
+
+float Calibrator::getProgress() const
+{
+    // Measuring takes about one frame per sample, since the GPU timers report every frame.
+    return std::min(static_cast<float>(frames) / static_cast<float>(warmupFrames + sampleCount), 1.0f);
+}
+
+bool Calibrator::isFinished() const
+{
+    return state == State::Finished;
+}
+
+std::string Calibrator::getReport() const
+{
+    std::string report;
+    for (size_t i = 0; i < medians.size(); ++i)
+    {
+        report += fmt::format("{}{} {:.2f} ms", i > 0 ? ", " : "", getPresets()[i].name, medians[i]);
+    }
+    return report;
+}
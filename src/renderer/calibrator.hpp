@@ -0,0 +1,61 @@
+#ifndef KUMIGAME_RENDERER_CALIBRATOR_HPP
+#define KUMIGAME_RENDERER_CALIBRATOR_HPP
+
+#include "antiAliasing.hpp"
+#include <string>
+#include <vector>
+
+struct GraphicsPreset
+{
+    const char* name;
+    float superSampling;
+    AntiAliasing antiAliasing;
+    int pointLights;
+};
+
+/**
+ * @brief Picks the best graphics preset whose GPU frame time stays within a target.
+ *
+ * Presets are tried from the best down. Each is rendered for some warm-up frames, so render targets are reallocated
+ * and the GPU timers catch up, then measured until enough GPU frame times came in. The first preset whose median meets
+ * the target is the result; if none does, the lowest is.
+ */
+class Calibrator
+{
+public:
+    explicit Calibrator(float targetFrameTime, unsigned int warmupFrames = 30, unsigned int sampleCount = 60);
+
+    // @brief Returns the presets in order of quality, best first.
+    static const std::vector<GraphicsPreset>& getPresets();
+
+    // @brief Counts a rendered frame, with the GPU frame time if new timings came in. Returns true when the preset
+    // to render changed or the calibration finished.
+    bool addFrame(bool newTimings, float gpuMilliseconds);
+
+    const GraphicsPreset& getPreset() const;
+    // @brief Returns how far the current preset is through its frames, from 0 to 1.
+    float getProgress() const;
+    bool isFinished() const;
+    // @brief Returns the median GPU frame time of every preset measured, for the log.
+    std::string getReport() const;
+
+private:
+    enum class State
+    {
+        Warmup,
+        Measuring,
+        Finished
+    };
+
+    float targetFrameTime;
+    unsigned int warmupFrames;
+    unsigned int sampleCount;
+
+    State state = State::Warmup;
+    size_t preset = 0;
+    unsigned int frames = 0;
+    std::vector<float> samples;
+    std::vector<float> medians;
+};
+
+#endif //KUMIGAME_RENDERER_CALIBRATOR_HPP
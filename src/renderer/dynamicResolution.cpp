@@ -0,0 +1,42 @@
+#include "dynamicResolution.hpp"
+#include <algorithm>
+
+DynamicResolution::DynamicResolution(float targetFrameTime, float minScale, float maxScale)
+    : targetFrameTime(targetFrameTime), minScale(minScale), maxScale(maxScale), scale(maxScale)
+{
+}
+
+void DynamicResolution::update(float gpuMilliseconds)
+{
+    if (targetFrameTime <= 0.0f || gpuMilliseconds <= 0.0f)
+    {
+        return;
+    }
+
+    // Positive when there is headroom, negative when over budget.
+    float error = (targetFrameTime - gpuMilliseconds) / targetFrameTime;
+    float delta = hasPreviousError ? error - previousError : 0.0f;
+    float deltaChange = hasPreviousError ? delta - previousDelta : 0.0f;
+    previousError = error;
+    previousDelta = delta;
+    hasPreviousError = true;
+
+    // Velocity form: the scale itself integrates the change, so the integral term works on the error and the
+    // proportional and derivative terms on its first and second differences. Clamping the scale is all the
+    // anti-windup needed, as there is no separate integral to wind up.
+    float change = proportionalGain * delta + integralGain * error + derivativeGain * deltaChange;
+    scale = std::clamp(scale + change, minScale, maxScale);
+}
+
+void DynamicResolution::reset(float newScale)
+{
+    scale = std::clamp(newScale, minScale, maxScale);
+    previousError = 0.0f;
+    previousDelta = 0.0f;
+    hasPreviousError = false;
+}
+
+float DynamicResolution::getScale() const
+{
+    return scale;
+}
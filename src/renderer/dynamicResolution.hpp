@@ -0,0 +1,36 @@
+#ifndef KUMIGAME_RENDERER_DYNAMIC_RESOLUTION_HPP
+#define KUMIGAME_RENDERER_DYNAMIC_RESOLUTION_HPP
+
+/**
+ * @brief Adjusts the internal render scale to keep GPU frame time near a target.
+ *
+ * A PID controller in velocity form works on the normalized frame time error, changing the scale each update rather
+ * than setting it. The scale is applied to both axes, so GPU cost changes roughly with its square; the gains are kept
+ * small to avoid oscillating around the target.
+ */
+class DynamicResolution
+{
+public:
+    float targetFrameTime;
+    float minScale;
+    float maxScale;
+    float proportionalGain = 0.05f;
+    float integralGain = 0.10f;
+    float derivativeGain = 0.02f;
+
+    DynamicResolution(float targetFrameTime, float minScale, float maxScale);
+
+    // @brief Feeds a new GPU frame time measurement in milliseconds to the controller.
+    void update(float gpuMilliseconds);
+    // @brief Resets the controller state and sets the scale.
+    void reset(float scale);
+    float getScale() const;
+
+private:
+    float scale;
+    float previousError = 0.0f;
+    float previousDelta = 0.0f;
+    bool hasPreviousError = false;
+};
+
+#endif //KUMIGAME_RENDERER_DYNAMIC_RESOLUTION_HPP
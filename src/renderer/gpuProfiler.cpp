@@ -0,0 +1,130 @@
+#include "gpuProfiler.hpp"
+#include "../debug/log.hpp"
+
+GpuProfiler::Scope::Scope(GpuProfiler& profiler, const std::string& name)
+    : profiler(profiler)
+{
+    profiler.begin(name);
+}
+
+GpuProfiler::Scope::~Scope()
+{
+    profiler.end();
+}
+
+GpuProfiler::Entry::Entry(const std::string& name, const std::string& path, unsigned int depth, unsigned int latency)
+    : name(name), path(path), depth(depth), timer(latency), lastFrame(0)
+{
+}
+
+GpuProfiler::GpuProfiler(unsigned int latency)
+    : latency(latency)
+{
+}
+
+void GpuProfiler::begin(const std::string& name)
+{
+    std::string path = stack.empty() ? name : entries[stack.back()]->path + "/" + name;
+
+    size_t index = 0;
+    while (index < entries.size() && entries[index]->path != path)
+    {
+        index++;
+    }
+
+    if (index == entries.size())
+    {
+        // Insert after the parent's existing children so the list stays in tree order. Only ancestors of the new
+        // scope are on the stack, and they all come before it, so their indices do not move.
+        auto depth = static_cast<unsigned int>(stack.size());
+        if (!stack.empty())
+        {
+            index = stack.back() + 1;
+            while (index < entries.size() && entries[index]->depth >= depth)
+            {
+                index++;
+            }
+        }
+        entries.insert(entries.begin() + static_cast<std::ptrdiff_t>(index),
+                       std::make_unique<Entry>(name, path, depth, latency));
+    }
+
+    Entry& entry = *entries[index];
+    entry.lastFrame = frame;
+    entry.timer.begin();
+    stack.push_back(index);
+}
+
+void GpuProfiler::end()
+{
+    if (stack.empty())
+    {
+        LOG_WARN("GPU profiler scope ended without being started.");
+        return;
+    }
+
+    entries[stack.back()]->timer.end();
+    stack.pop_back();
+}
+
+bool GpuProfiler::poll()
+{
+    if (!stack.empty())
+    {
+        LOG_WARN("GPU profiler scope \"{}\" was not ended.", entries[stack.back()]->path);
+        stack.clear();
+    }
+
+    bool updated = false;
+    for (auto& entry : entries)
+    {
+        updated |= entry->timer.poll();
+    }
+
+    frame++;
+    return updated;
+}
+
+float GpuProfiler::getMilliseconds(const std::string& path) const
+{
+    for (const auto& entry : entries)
+    {
+        if (entry->path == path)
+        {
+            return isRecent(*entry) ? entry->timer.getMilliseconds() : 0.0f;
+        }
+    }
+    return 0.0f;
+}
+
+float GpuProfiler::getFrameMilliseconds() const
+{
+    float milliseconds = 0.0f;
+    for (const auto& entry : entries)
+    {
+        if (entry->depth == 0 && isRecent(*entry))
+        {
+            milliseconds += entry->timer.getMilliseconds();
+        }
+    }
+    return milliseconds;
+}
+
+std::vector<GpuProfiler::Timing> GpuProfiler::getTimings() const
+{
+    std::vector<Timing> timings;
+    for (const auto& entry : entries)
+    {
+        if (isRecent(*entry))
+        {
+            timings.push_back({ entry->name, entry->path, entry->depth, entry->timer.getMilliseconds() });
+        }
+    }
+    return timings;
+}
+
+bool GpuProfiler::isRecent(const Entry& entry) const
+{
+    // Results lag by up to the latency of the timer, so a scope stays listed a little longer than that.
+    return frame - entry.lastFrame <= 2ull * latency;
+}
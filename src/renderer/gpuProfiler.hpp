@@ -0,0 +1,79 @@
+#ifndef KUMIGAME_RENDERER_GPU_PROFILER_HPP
+#define KUMIGAME_RENDERER_GPU_PROFILER_HPP
+
+#include "gpuTimer.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Measures GPU time of named, nested scopes.
+ *
+ * Every scope is timed by its own GpuTimer, so results are read back several frames late and never stall. Scopes are
+ * identified by their path, e.g. "scene/lamps", and kept in the order they were first opened with children after
+ * their parent. Timestamps are used rather than GL_TIME_ELAPSED queries because those cannot be nested.
+ */
+class GpuProfiler
+{
+public:
+    struct Timing
+    {
+        std::string name;
+        std::string path;
+        unsigned int depth;
+        float milliseconds;
+    };
+
+    // @brief Times the lifetime of the object as a scope of the profiler.
+    class Scope
+    {
+    public:
+        Scope(GpuProfiler& profiler, const std::string& name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& profiler;
+    };
+
+    explicit GpuProfiler(unsigned int latency = 4);
+
+    // @brief Starts a scope nested in the currently open one.
+    void begin(const std::string& name);
+    // @brief Ends the most recently started scope.
+    void end();
+
+    // @brief Reads back finished queries and starts a new frame. Returns whether a new result is available.
+    bool poll();
+
+    // @brief Returns the latest time of a scope in milliseconds, or zero if it has not been timed recently.
+    float getMilliseconds(const std::string& path) const;
+    // @brief Returns the sum of the latest times of the outermost scopes.
+    float getFrameMilliseconds() const;
+    // @brief Returns the latest time of every scope timed recently, parents before their children.
+    std::vector<Timing> getTimings() const;
+
+private:
+    struct Entry
+    {
+        std::string name;
+        std::string path;
+        unsigned int depth;
+        GpuTimer timer;
+        unsigned long long lastFrame;
+
+        Entry(const std::string& name, const std::string& path, unsigned int depth, unsigned int latency);
+    };
+
+    std::vector<std::unique_ptr<Entry>> entries;
+    // Indices of the open scopes, outermost first.
+    std::vector<size_t> stack;
+    unsigned int latency;
+    unsigned long long frame = 0;
+
+    bool isRecent(const Entry& entry) const;
+};
+
+#endif //KUMIGAME_RENDERER_GPU_PROFILER_HPP
@@ -0,0 +1,64 @@
+#include "gpuTimer.hpp"
+#include <glad/glad.h>
+
+GpuTimer::GpuTimer(unsigned int latency)
+    : queries(latency * 2), pending(latency, false), latency(latency)
+{
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+}
+
+GpuTimer::~GpuTimer()
+{
+    glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+}
+
+void GpuTimer::begin()
+{
+    // Drop the oldest measurement if the ring is full rather than waiting on it.
+    if (pending[writeIndex])
+    {
+        pending[writeIndex] = false;
+        readIndex = (writeIndex + 1) % latency;
+    }
+
+    glQueryCounter(queries[writeIndex * 2], GL_TIMESTAMP);
+}
+
+void GpuTimer::end()
+{
+    glQueryCounter(queries[writeIndex * 2 + 1], GL_TIMESTAMP);
+    pending[writeIndex] = true;
+    writeIndex = (writeIndex + 1) % latency;
+}
+
+bool GpuTimer::poll()
+{
+    bool updated = false;
+
+    while (pending[readIndex])
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(queries[readIndex * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            break;
+        }
+
+        GLuint64 start;
+        GLuint64 stop;
+        glGetQueryObjectui64v(queries[readIndex * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(queries[readIndex * 2 + 1], GL_QUERY_RESULT, &stop);
+        milliseconds = static_cast<float>(static_cast<double>(stop - start) / 1.0e6);
+        updated = true;
+
+        pending[readIndex] = false;
+        readIndex = (readIndex + 1) % latency;
+    }
+
+    return updated;
+}
+
+float GpuTimer::getMilliseconds() const
+{
+    return milliseconds;
+}
@@ -0,0 +1,39 @@
+#ifndef KUMIGAME_RENDERER_GPU_TIMER_HPP
+#define KUMIGAME_RENDERER_GPU_TIMER_HPP
+
+#include <glad/glad.h>
+#include <vector>
+
+/**
+ * @brief Measures GPU time between begin() and end() with timestamp queries.
+ *
+ * Queries are kept in a ring several frames deep and only read back once the driver reports them available, so
+ * reading a result never stalls the pipeline. Results lag the frame they measure by a few frames.
+ */
+class GpuTimer
+{
+public:
+    explicit GpuTimer(unsigned int latency = 4);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin();
+    void end();
+
+    // @brief Reads back finished queries. Returns whether a new result is available.
+    bool poll();
+    // @brief Returns the most recently read back result in milliseconds.
+    float getMilliseconds() const;
+
+private:
+    std::vector<GLuint> queries;
+    std::vector<bool> pending;
+    unsigned int latency;
+    unsigned int writeIndex = 0;
+    unsigned int readIndex = 0;
+    float milliseconds = 0.0f;
+};
+
+#endif //KUMIGAME_RENDERER_GPU_TIMER_HPP
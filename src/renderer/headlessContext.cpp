@@ -0,0 +1,111 @@
+#include "headlessContext.hpp"
+#include <fmt/format.h>
+
+#ifdef KUMIGAME_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+namespace
+{
+    std::string eglErrorString()
+    {
+        return fmt::format("EGL error 0x{:x}", eglGetError());
+    }
+}
+
+HeadlessContext::~HeadlessContext()
+{
+    if (context)
+    {
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+    }
+    if (display)
+    {
+        eglTerminate(display);
+    }
+}
+
+std::optional<std::string> HeadlessContext::create(int major, int minor, bool debug)
+{
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!getPlatformDisplay)
+    {
+        return "EGL_EXT_platform_base is not supported.";
+    }
+
+    display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY)
+    {
+        display = nullptr;
+        return "No surfaceless EGL display (EGL_MESA_platform_surfaceless) is available.";
+    }
+
+    EGLint eglMajor, eglMinor;
+    if (!eglInitialize(display, &eglMajor, &eglMinor))
+    {
+        std::string error = eglErrorString();
+        display = nullptr;
+        return fmt::format("Failed to initialize EGL: {}.", error);
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        return fmt::format("EGL does not support desktop OpenGL: {}.", eglErrorString());
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs == 0)
+    {
+        return fmt::format("No EGL config supports OpenGL: {}.", eglErrorString());
+    }
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, major,
+        EGL_CONTEXT_MINOR_VERSION, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_DEBUG, debug ? EGL_TRUE : EGL_FALSE,
+        EGL_NONE
+    };
+    context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (context == EGL_NO_CONTEXT)
+    {
+        context = nullptr;
+        return fmt::format("Failed to create an OpenGL {}.{} context: {}.", major, minor, eglErrorString());
+    }
+
+    // Requires EGL_KHR_surfaceless_context, which every surfaceless display has.
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        return fmt::format("Failed to make the context current: {}.", eglErrorString());
+    }
+
+    return {};
+}
+
+GLADloadproc HeadlessContext::getLoader()
+{
+    return reinterpret_cast<GLADloadproc>(eglGetProcAddress);
+}
+
+#else
+
+HeadlessContext::~HeadlessContext() = default;
+
+std::optional<std::string> HeadlessContext::create(int, int, bool)
+{
+    return "Built without EGL support. Configure with -DKUMIGAME_EGL=ON.";
+}
+
+GLADloadproc HeadlessContext::getLoader()
+{
+    return nullptr;
+}
+
+#endif
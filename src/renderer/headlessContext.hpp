@@ -0,0 +1,35 @@
+#ifndef KUMIGAME_RENDERER_HEADLESS_CONTEXT_HPP
+#define KUMIGAME_RENDERER_HEADLESS_CONTEXT_HPP
+
+#include <glad/glad.h>
+#include <optional>
+#include <string>
+
+/**
+ * @brief An OpenGL context without a window or display server.
+ *
+ * Created with EGL on a surfaceless display (EGL_MESA_platform_surfaceless), which also works without a GPU through
+ * Mesa's llvmpipe. The context has no default framebuffer, so everything must be drawn into framebuffer objects.
+ * Only available when building with the KUMIGAME_EGL option; otherwise create() always fails.
+ */
+class HeadlessContext
+{
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // @brief Creates a core profile context of the given version and makes it current on the calling thread.
+    std::optional<std::string> create(int major, int minor, bool debug);
+    // @brief Returns the function glad loads GL functions with.
+    static GLADloadproc getLoader();
+
+private:
+    // EGLDisplay and EGLContext, kept opaque so the EGL headers stay out of the rest of the game.
+    void* display = nullptr;
+    void* context = nullptr;
+};
+
+#endif //KUMIGAME_RENDERER_HEADLESS_CONTEXT_HPP
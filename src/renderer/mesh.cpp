@@ -1,4 +1,5 @@
 #include "mesh.hpp"
+#include "../debug/memoryTracker.hpp"
 #include <fmt/format.h>
 #include <glad/glad.h>
 #include <utility>
@@ -49,9 +50,11 @@ void Mesh::setupMesh()
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    MemoryTracker::trackBuffer(vbo, MemoryCategory::Mesh, vertices.size() * sizeof(Vertex));
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0], GL_STATIC_DRAW);
+    MemoryTracker::trackBuffer(ebo, MemoryCategory::Mesh, indices.size() * sizeof(GLuint));
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
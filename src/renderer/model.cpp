@@ -2,6 +2,8 @@
 #include "material.hpp"
 #include "shader.hpp"
 #include "../debug/log.hpp"
+#include "../debug/memoryTracker.hpp"
+#include "../debug/profiler.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
@@ -36,6 +38,9 @@ void Model::setMeshMaterial(size_t meshIndex, size_t materialIndex, Material mat
 
 void Model::loadModel(const std::string &path)
 {
+    PROFILE_SCOPE("Model::loadModel");
+    MemoryScope memoryScope(MemoryCategory::Mesh);
+
     Assimp::Importer import;
     const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
 
@@ -18,6 +18,9 @@ public:
     void setMeshMaterial(size_t meshIndex, size_t materialIndex, Material material);
 
 private:
+    // Lets the micro-benchmarks time mesh conversion on its own.
+    friend struct ModelBenchmarkAccess;
+
     std::vector<Mesh> meshes;
     std::vector<Texture> texturesLoaded;
     std::string directory;
@@ -0,0 +1,273 @@
+#include "postProcess.hpp"
+#include "renderTarget.hpp"
+#include "shader.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace
+{
+    const float EDGE_KERNEL[9] = {
+        1.0f,  1.0f, 1.0f,
+        1.0f, -8.0f, 1.0f,
+        1.0f,  1.0f, 1.0f
+    };
+
+    const float SHARPEN_KERNEL[9] = {
+        -1.0f, -1.0f, -1.0f,
+        -1.0f,  9.0f, -1.0f,
+        -1.0f, -1.0f, -1.0f
+    };
+
+    const int BLUR_GROUP_SIZE = 256;
+
+    GLuint groupCount(int size, int groupSize)
+    {
+        return static_cast<GLuint>((size + groupSize - 1) / groupSize);
+    }
+}
+
+std::optional<PostProcess> postProcessFromString(const std::string& name)
+{
+    if (name == "blur")
+    {
+        return PostProcess::Blur;
+    }
+    if (name == "edge")
+    {
+        return PostProcess::Edge;
+    }
+    if (name == "greyscale" || name == "grayscale")
+    {
+        return PostProcess::Greyscale;
+    }
+    if (name == "invert")
+    {
+        return PostProcess::Invert;
+    }
+    if (name == "sharpen")
+    {
+        return PostProcess::Sharpen;
+    }
+    return {};
+}
+
+PostProcessChain::PostProcessChain(GLuint quadVAO)
+    : quadVAO(quadVAO)
+{
+    blurShader = std::make_shared<Shader>("assets/shaders/screen.vert", "assets/shaders/blur.frag");
+    kernelShader = std::make_shared<Shader>("assets/shaders/screen.vert", "assets/shaders/kernel.frag");
+    colorMatrixShader = std::make_shared<Shader>("assets/shaders/screen.vert", "assets/shaders/colorMatrix.frag");
+    fxaaShader = std::make_shared<Shader>("assets/shaders/screen.vert", "assets/shaders/fxaa.frag");
+    blurComputeShader = std::make_shared<Shader>();
+    blurComputeShader->loadComputeFromFile("assets/shaders/blur.comp");
+
+    // Order in which enabled effects are applied. Effects with several passes have one entry per pass.
+    passes = {
+        { PostProcess::Fxaa, "fxaa", &PostProcessChain::fxaa },
+        { PostProcess::Blur, "blurHorizontal", &PostProcessChain::blurHorizontal },
+        { PostProcess::Blur, "blurVertical", &PostProcessChain::blurVertical },
+        { PostProcess::Sharpen, "sharpen", &PostProcessChain::sharpen },
+        { PostProcess::Edge, "edge", &PostProcessChain::edge },
+        { PostProcess::Greyscale, "greyscale", &PostProcessChain::greyscale },
+        { PostProcess::Invert, "invert", &PostProcessChain::invert }
+    };
+}
+
+RenderResource PostProcessChain::addPasses(RenderGraph& graph, RenderResource input, glm::ivec2 viewport)
+{
+    if (enabled == PostProcess::Off)
+    {
+        return input;
+    }
+
+    if (enabled & PostProcess::Blur)
+    {
+        updateBlurWeights();
+    }
+
+    glm::ivec2 size = graph.getDesc(input).size;
+    glm::vec2 targetSize = glm::vec2(size);
+    PassContext context = {
+        .desc = {
+            .size = size,
+            .colorFormat = GL_RGBA8,
+            .depthFormat = GL_NONE
+        },
+        .viewport = viewport,
+        .uvScale = glm::vec2(viewport) / targetSize,
+        .uvMax = (glm::vec2(viewport) - 0.5f) / targetSize
+    };
+
+    RenderResource source = input;
+    graph.setGroup("post");
+    for (const auto& pass : passes)
+    {
+        if (!(enabled & pass.effect))
+        {
+            continue;
+        }
+
+        RenderResource destination = graph.createTexture(pass.name, context.desc);
+        auto run = pass.run;
+        graph.addPass(pass.name, { source }, { destination }, [this, run, context, source, destination](const RenderGraph& graph) {
+            (this->*run)(context, graph.getTarget(source).colorTexture, graph.getTarget(destination));
+        });
+        source = destination;
+    }
+    graph.setGroup("");
+
+    return source;
+}
+
+void PostProcessChain::blurHorizontal(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    blur(context, source, destination, glm::ivec2(1, 0));
+}
+
+void PostProcessChain::blurVertical(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    blur(context, source, destination, glm::ivec2(0, 1));
+}
+
+void PostProcessChain::edge(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    kernel(context, source, destination, EDGE_KERNEL);
+}
+
+void PostProcessChain::sharpen(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    kernel(context, source, destination, SHARPEN_KERNEL);
+}
+
+void PostProcessChain::greyscale(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    // Every output channel is the Rec. 709 luminance of the input.
+    glm::mat3 luminance = glm::mat3(glm::vec3(0.2126f), glm::vec3(0.7152f), glm::vec3(0.0722f));
+    colorMatrix(context, source, destination, luminance, glm::vec3(0.0f));
+}
+
+void PostProcessChain::invert(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    colorMatrix(context, source, destination, glm::mat3(-1.0f), glm::vec3(1.0f));
+}
+
+void PostProcessChain::fxaa(const PassContext& context, GLuint source, const RenderTarget& destination)
+{
+    drawQuad(context, fxaaShader, source, destination);
+}
+
+void PostProcessChain::updateBlurWeights()
+{
+    blurRadius = std::clamp(blurRadius, 1, MAX_BLUR_RADIUS);
+    if (blurRadius == weightsRadius)
+    {
+        return;
+    }
+    weightsRadius = blurRadius;
+
+    // Discrete Gaussian weights for offsets 0 to radius, normalized over the whole kernel.
+    float sigma = std::max(static_cast<float>(weightsRadius) / 3.0f, 0.5f);
+    blurWeights.resize(static_cast<size_t>(weightsRadius) + 1);
+    float sum = 0.0f;
+    for (int i = 0; i <= weightsRadius; ++i)
+    {
+        float weight = std::exp(-static_cast<float>(i * i) / (2.0f * sigma * sigma));
+        blurWeights[static_cast<size_t>(i)] = weight;
+        sum += i == 0 ? weight : 2.0f * weight;
+    }
+    for (auto& weight : blurWeights)
+    {
+        weight /= sum;
+    }
+
+    // Merge neighbouring taps into one bilinear fetch placed between them in proportion to their weights.
+    linearWeights = { blurWeights[0] };
+    linearOffsets = { 0.0f };
+    for (int i = 1; i <= weightsRadius; i += 2)
+    {
+        float first = blurWeights[static_cast<size_t>(i)];
+        float second = i + 1 <= weightsRadius ? blurWeights[static_cast<size_t>(i) + 1] : 0.0f;
+        float weight = first + second;
+        linearWeights.push_back(weight);
+        linearOffsets.push_back((static_cast<float>(i) * first + static_cast<float>(i + 1) * second) / weight);
+    }
+}
+
+void PostProcessChain::blur(const PassContext& context, GLuint source, const RenderTarget& destination,
+                            glm::ivec2 direction)
+{
+    if (weightsRadius > COMPUTE_BLUR_RADIUS)
+    {
+        blurCompute(context, source, destination, direction);
+        return;
+    }
+
+    glm::vec2 texel = 1.0f / glm::vec2(context.desc.size);
+    auto tapCount = static_cast<GLuint>(linearWeights.size());
+
+    blurShader->use();
+    blurShader->setInteger("TapCount", static_cast<GLint>(tapCount));
+    blurShader->setFloatArray("Weights", tapCount, linearWeights.data());
+    blurShader->setFloatArray("Offsets", tapCount, linearOffsets.data());
+    blurShader->setVector2f("Direction", glm::vec2(direction) * texel);
+    drawQuad(context, blurShader, source, destination);
+}
+
+void PostProcessChain::blurCompute(const PassContext& context, GLuint source, const RenderTarget& destination,
+                                   glm::ivec2 direction)
+{
+    blurComputeShader->use();
+    blurComputeShader->setInteger("Source", 0);
+    blurComputeShader->setInteger("Destination", 0);
+    blurComputeShader->setInteger("Radius", weightsRadius);
+    blurComputeShader->setFloatArray("Weights", static_cast<GLuint>(blurWeights.size()), blurWeights.data());
+    glUniform2i(blurComputeShader->getUniformLocation("Size"), context.viewport.x, context.viewport.y);
+    glUniform2i(blurComputeShader->getUniformLocation("Direction"), direction.x, direction.y);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glBindImageTexture(0, destination.colorTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+
+    // One work group per GROUP_SIZE texels along the blur direction, one row of groups per line across it.
+    int along = direction.x ? context.viewport.x : context.viewport.y;
+    int across = direction.x ? context.viewport.y : context.viewport.x;
+    glDispatchCompute(groupCount(along, BLUR_GROUP_SIZE), static_cast<GLuint>(across), 1);
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+}
+
+void PostProcessChain::kernel(const PassContext& context, GLuint source, const RenderTarget& destination,
+                              const float* weights)
+{
+    kernelShader->use();
+    kernelShader->setFloatArray("Kernel", 9, weights);
+    drawQuad(context, kernelShader, source, destination);
+}
+
+void PostProcessChain::colorMatrix(const PassContext& context, GLuint source, const RenderTarget& destination,
+                                   const glm::mat3& matrix, const glm::vec3& offset)
+{
+    colorMatrixShader->use();
+    colorMatrixShader->setMatrix3("ColorMatrix", matrix);
+    colorMatrixShader->setVector3f("ColorOffset", offset);
+    drawQuad(context, colorMatrixShader, source, destination);
+}
+
+void PostProcessChain::drawQuad(const PassContext& context, const std::shared_ptr<Shader>& shader, GLuint source,
+                                const RenderTarget& destination)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, destination.fbo);
+    glViewport(0, 0, context.viewport.x, context.viewport.y);
+
+    shader->use();
+    shader->setInteger("Source", 0);
+    shader->setVector2f("UvScale", context.uvScale);
+    shader->setVector2f("UvMax", context.uvMax);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, source);
+    glBindVertexArray(quadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+}
@@ -1,14 +1,97 @@
 #ifndef KUMIGAME_RENDERER_POSTPROCESS_HPP
 #define KUMIGAME_RENDERER_POSTPROCESS_HPP
 
-enum PostProcess
+#include "renderGraph.hpp"
+#include "renderTarget.hpp"
+#include "shader.hpp"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+enum PostProcess : uint32_t
 {
     Off = 0,
-    Blur = 1,
-    Edge = 2,
-    Greyscale = 3,
-    Invert = 4,
-    Sharpen = 5
+    Blur = 1 << 0,
+    Edge = 1 << 1,
+    Greyscale = 1 << 2,
+    Invert = 1 << 3,
+    Sharpen = 1 << 4,
+    Fxaa = 1 << 5
+};
+
+std::optional<PostProcess> postProcessFromString(const std::string& name);
+
+/**
+ * @brief Applies the enabled post-processing effects in a fixed order.
+ *
+ * Each enabled effect is added to the render graph as passes reading the previous output and writing a new transient
+ * texture; the graph aliases those textures so the chain only needs two targets however many effects are enabled.
+ * With nothing enabled the input is returned as is. All textures have the size of the input and the passes only touch
+ * the viewport rectangle in its corner.
+ */
+class PostProcessChain
+{
+public:
+    static const int MAX_BLUR_RADIUS = 64;
+    // Blurs wider than this run as compute shaders with shared-memory tiling.
+    static const int COMPUTE_BLUR_RADIUS = 16;
+
+    uint32_t enabled = PostProcess::Off;
+    int blurRadius = 8;
+
+    explicit PostProcessChain(GLuint quadVAO);
+
+    // @brief Adds the enabled passes to the graph and returns the resource holding the result.
+    RenderResource addPasses(RenderGraph& graph, RenderResource input, glm::ivec2 viewport);
+
+private:
+    struct PassContext
+    {
+        RenderTargetDesc desc;
+        glm::ivec2 viewport;
+        glm::vec2 uvScale;
+        glm::vec2 uvMax;
+    };
+
+    struct Pass
+    {
+        PostProcess effect;
+        const char* name;
+        void (PostProcessChain::*run)(const PassContext& context, GLuint source, const RenderTarget& destination);
+    };
+
+    GLuint quadVAO;
+    std::shared_ptr<Shader> blurShader;
+    std::shared_ptr<Shader> blurComputeShader;
+    std::shared_ptr<Shader> kernelShader;
+    std::shared_ptr<Shader> colorMatrixShader;
+    std::shared_ptr<Shader> fxaaShader;
+    std::vector<Pass> passes;
+    int weightsRadius = 0;
+    std::vector<float> blurWeights;
+    std::vector<float> linearWeights;
+    std::vector<float> linearOffsets;
+
+    void blurHorizontal(const PassContext& context, GLuint source, const RenderTarget& destination);
+    void blurVertical(const PassContext& context, GLuint source, const RenderTarget& destination);
+    void edge(const PassContext& context, GLuint source, const RenderTarget& destination);
+    void sharpen(const PassContext& context, GLuint source, const RenderTarget& destination);
+    void greyscale(const PassContext& context, GLuint source, const RenderTarget& destination);
+    void invert(const PassContext& context, GLuint source, const RenderTarget& destination);
+    void fxaa(const PassContext& context, GLuint source, const RenderTarget& destination);
+
+    void updateBlurWeights();
+    void blur(const PassContext& context, GLuint source, const RenderTarget& destination, glm::ivec2 direction);
+    void blurCompute(const PassContext& context, GLuint source, const RenderTarget& destination, glm::ivec2 direction);
+    void kernel(const PassContext& context, GLuint source, const RenderTarget& destination, const float* weights);
+    void colorMatrix(const PassContext& context, GLuint source, const RenderTarget& destination,
+                     const glm::mat3& matrix, const glm::vec3& offset);
+    void drawQuad(const PassContext& context, const std::shared_ptr<Shader>& shader, GLuint source,
+                  const RenderTarget& destination);
 };
 
 #endif //KUMIGAME_RENDERER_POSTPROCESS_HPP
@@ -0,0 +1,413 @@
+#include "renderGraph.hpp"
+#include "../debug/log.hpp"
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+namespace
+{
+    const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    const uint64_t FNV_PRIME = 1099511628211ull;
+
+    void hashBytes(uint64_t& hash, const void* data, size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+    }
+
+    template<typename T>
+    void hashValue(uint64_t& hash, const T& value)
+    {
+        hashBytes(hash, &value, sizeof(T));
+    }
+
+    void hashString(uint64_t& hash, const std::string& value)
+    {
+        hashValue(hash, value.size());
+        hashBytes(hash, value.data(), value.size());
+    }
+
+    bool contains(const std::vector<RenderResource>& resources, RenderResource resource)
+    {
+        return std::find(resources.begin(), resources.end(), resource) != resources.end();
+    }
+}
+
+RenderGraph::RenderGraph(RenderTargetManager& targets)
+    : targets(targets)
+{
+}
+
+void RenderGraph::reset()
+{
+    resources.clear();
+    passes.clear();
+    group.clear();
+}
+
+void RenderGraph::setProfiler(GpuProfiler* gpuProfiler)
+{
+    profiler = gpuProfiler;
+}
+
+void RenderGraph::setGroup(const std::string& name)
+{
+    group = name;
+}
+
+RenderResource RenderGraph::createTexture(const std::string& name, const RenderTargetDesc& desc)
+{
+    resources.push_back({ .name = name, .desc = desc });
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+RenderResource RenderGraph::importTarget(const std::string& name, const RenderTarget& target)
+{
+    resources.push_back({ .name = name, .desc = target.desc, .imported = &target });
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+void RenderGraph::addPass(const std::string& name, const std::vector<RenderResource>& reads,
+                          const std::vector<RenderResource>& writes, PassFunction execute)
+{
+    passes.push_back({ .name = name, .group = group, .reads = reads, .writes = writes, .execute = std::move(execute) });
+}
+
+void RenderGraph::compile()
+{
+    uint64_t currentHash = hash();
+    if (compiled && currentHash == compiledHash)
+    {
+        return;
+    }
+
+    std::vector<bool> live = cull();
+    order = sort(live);
+    culledCount = passes.size() - order.size();
+    allocate();
+
+    compiledHash = currentHash;
+    compiled = true;
+
+    LOG_DEBUG("Compiled render graph: {} passes, {} culled, {} transient targets.",
+              order.size(), culledCount, slots.size());
+}
+
+void RenderGraph::execute()
+{
+    if (!compiled)
+    {
+        compile();
+    }
+
+    slotTargets.assign(slots.size(), nullptr);
+    std::string openGroup;
+    for (size_t position = 0; position < order.size(); ++position)
+    {
+        // Targets are only held between their first and last use, so the pool can hand them out again in between.
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (slots[i].firstUse == position)
+            {
+                slotTargets[i] = targets.acquire(slots[i].desc);
+            }
+        }
+
+        Pass& pass = passes[order[position]];
+        if (profiler)
+        {
+            if (pass.group != openGroup)
+            {
+                if (!openGroup.empty())
+                {
+                    profiler->end();
+                }
+                if (!pass.group.empty())
+                {
+                    profiler->begin(pass.group);
+                }
+                openGroup = pass.group;
+            }
+            profiler->begin(pass.name);
+        }
+
+        pass.execute(*this);
+
+        if (profiler)
+        {
+            profiler->end();
+        }
+
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (slots[i].lastUse == position)
+            {
+                targets.release(slotTargets[i]);
+                slotTargets[i] = nullptr;
+            }
+        }
+    }
+
+    if (profiler && !openGroup.empty())
+    {
+        profiler->end();
+    }
+}
+
+const RenderTargetDesc& RenderGraph::getDesc(RenderResource resource) const
+{
+    return resources[resource].desc;
+}
+
+const RenderTarget& RenderGraph::getTarget(RenderResource resource) const
+{
+    const Resource& entry = resources[resource];
+    if (entry.imported)
+    {
+        return *entry.imported;
+    }
+    return *slotTargets[resourceSlots[resource]];
+}
+
+size_t RenderGraph::getPassCount() const
+{
+    return order.size();
+}
+
+size_t RenderGraph::getCulledPassCount() const
+{
+    return culledCount;
+}
+
+size_t RenderGraph::getTransientTargetCount() const
+{
+    return slots.size();
+}
+
+uint64_t RenderGraph::hash() const
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    hashValue(hash, resources.size());
+    for (const auto& resource : resources)
+    {
+        hashString(hash, resource.name);
+        hashValue(hash, resource.imported != nullptr);
+        if (!resource.imported)
+        {
+            hashValue(hash, resource.desc.size.x);
+            hashValue(hash, resource.desc.size.y);
+            hashValue(hash, resource.desc.colorFormat);
+            hashValue(hash, resource.desc.depthFormat);
+            hashValue(hash, resource.desc.samples);
+            hashValue(hash, resource.desc.velocityFormat);
+        }
+    }
+
+    hashValue(hash, passes.size());
+    for (const auto& pass : passes)
+    {
+        hashString(hash, pass.name);
+        hashValue(hash, pass.reads.size());
+        hashBytes(hash, pass.reads.data(), pass.reads.size() * sizeof(RenderResource));
+        hashValue(hash, pass.writes.size());
+        hashBytes(hash, pass.writes.data(), pass.writes.size() * sizeof(RenderResource));
+    }
+
+    return hash;
+}
+
+bool RenderGraph::writes(const Pass& pass, RenderResource resource) const
+{
+    return contains(pass.writes, resource);
+}
+
+std::vector<bool> RenderGraph::cull() const
+{
+    // Passes writing an imported target are always kept; from there, walk back to the writers of everything read.
+    std::vector<bool> live(passes.size(), false);
+    std::vector<size_t> stack;
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        for (auto resource : passes[i].writes)
+        {
+            if (resources[resource].imported && !live[i])
+            {
+                live[i] = true;
+                stack.push_back(i);
+            }
+        }
+    }
+
+    while (!stack.empty())
+    {
+        size_t current = stack.back();
+        stack.pop_back();
+
+        for (auto resource : passes[current].reads)
+        {
+            for (size_t i = 0; i < passes.size(); ++i)
+            {
+                if (!live[i] && writes(passes[i], resource))
+                {
+                    live[i] = true;
+                    stack.push_back(i);
+                }
+            }
+        }
+    }
+
+    return live;
+}
+
+std::vector<size_t> RenderGraph::sort(const std::vector<bool>& live) const
+{
+    // A pass depends on every other pass writing a resource it reads, and passes writing the same resource keep
+    // their declaration order.
+    std::vector<std::vector<size_t>> dependents(passes.size());
+    std::vector<size_t> dependencyCount(passes.size(), 0);
+    auto addEdge = [&](size_t from, size_t to) {
+        if (std::find(dependents[from].begin(), dependents[from].end(), to) == dependents[from].end())
+        {
+            dependents[from].push_back(to);
+            dependencyCount[to]++;
+        }
+    };
+
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        if (!live[i])
+        {
+            continue;
+        }
+
+        for (size_t j = 0; j < passes.size(); ++j)
+        {
+            if (i == j || !live[j])
+            {
+                continue;
+            }
+
+            for (auto resource : passes[i].reads)
+            {
+                if (writes(passes[j], resource))
+                {
+                    addEdge(j, i);
+                }
+            }
+            for (auto resource : passes[i].writes)
+            {
+                if (j < i && writes(passes[j], resource))
+                {
+                    addEdge(j, i);
+                }
+            }
+        }
+    }
+
+    // Kahn's algorithm, preferring the pass declared first whenever several are ready.
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<>> ready;
+    size_t liveCount = 0;
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        if (live[i])
+        {
+            liveCount++;
+            if (dependencyCount[i] == 0)
+            {
+                ready.push(i);
+            }
+        }
+    }
+
+    std::vector<size_t> sorted;
+    while (!ready.empty())
+    {
+        size_t current = ready.top();
+        ready.pop();
+        sorted.push_back(current);
+
+        for (auto dependent : dependents[current])
+        {
+            if (--dependencyCount[dependent] == 0)
+            {
+                ready.push(dependent);
+            }
+        }
+    }
+
+    if (sorted.size() != liveCount)
+    {
+        LOG_ERROR("Render graph has a dependency cycle, running passes in declaration order.");
+        sorted.clear();
+        for (size_t i = 0; i < passes.size(); ++i)
+        {
+            if (live[i])
+            {
+                sorted.push_back(i);
+            }
+        }
+    }
+
+    return sorted;
+}
+
+void RenderGraph::allocate()
+{
+    const size_t unused = std::numeric_limits<size_t>::max();
+
+    // Lifetime of every transient resource as a range of positions in the compiled order.
+    std::vector<size_t> firstUse(resources.size(), unused);
+    std::vector<size_t> lastUse(resources.size(), 0);
+    for (size_t position = 0; position < order.size(); ++position)
+    {
+        const Pass& pass = passes[order[position]];
+        for (const auto& list : { pass.reads, pass.writes })
+        {
+            for (auto resource : list)
+            {
+                firstUse[resource] = std::min(firstUse[resource], position);
+                lastUse[resource] = std::max(lastUse[resource], position);
+            }
+        }
+    }
+
+    std::vector<RenderResource> transient;
+    for (RenderResource resource = 0; resource < resources.size(); ++resource)
+    {
+        if (!resources[resource].imported && firstUse[resource] != unused)
+        {
+            transient.push_back(resource);
+        }
+    }
+    std::sort(transient.begin(), transient.end(), [&](RenderResource a, RenderResource b) {
+        return firstUse[a] < firstUse[b];
+    });
+
+    // Greedy interval assignment: a resource reuses a slot with the same description whose previous occupant is no
+    // longer needed, so the number of slots is the peak number of simultaneously live resources.
+    slots.clear();
+    resourceSlots.assign(resources.size(), 0);
+    for (auto resource : transient)
+    {
+        const RenderTargetDesc& desc = resources[resource].desc;
+        auto slot = std::find_if(slots.begin(), slots.end(), [&](const Slot& candidate) {
+            return candidate.desc == desc && candidate.lastUse < firstUse[resource];
+        });
+
+        if (slot == slots.end())
+        {
+            slots.push_back({ .desc = desc, .firstUse = firstUse[resource], .lastUse = lastUse[resource] });
+            resourceSlots[resource] = slots.size() - 1;
+        }
+        else
+        {
+            slot->lastUse = lastUse[resource];
+            resourceSlots[resource] = static_cast<size_t>(slot - slots.begin());
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef KUMIGAME_RENDERER_RENDER_GRAPH_HPP
+#define KUMIGAME_RENDERER_RENDER_GRAPH_HPP
+
+#include "gpuProfiler.hpp"
+#include "renderTarget.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef uint32_t RenderResource;
+
+/**
+ * @brief Per-frame graph of render passes and the targets they read and write.
+ *
+ * Passes are declared every frame together with the resources they read and write. Compiling the graph culls passes
+ * whose outputs never reach an imported target, orders the remaining passes by their dependencies, and assigns
+ * transient resources to pooled targets so that resources with non-overlapping lifetimes share one target. The
+ * compiled result is reused as long as the declared graph does not change between frames. With a profiler set, every
+ * executed pass is timed on the GPU, nested in the scope of its group if it has one.
+ */
+class RenderGraph
+{
+public:
+    typedef std::function<void(const RenderGraph& graph)> PassFunction;
+
+    explicit RenderGraph(RenderTargetManager& targets);
+
+    // @brief Removes all passes and resources so the next frame can be declared.
+    void reset();
+    // @brief Times every executed pass with the profiler. Passing null disables timing.
+    void setProfiler(GpuProfiler* gpuProfiler);
+    // @brief Puts the passes added after this call in a group, timed as one scope. An empty name ends the group.
+    void setGroup(const std::string& name);
+
+    // @brief Declares a target that only lives while the passes using it run.
+    RenderResource createTexture(const std::string& name, const RenderTargetDesc& desc);
+    // @brief Declares a target owned outside the graph. Passes writing it are never culled.
+    RenderResource importTarget(const std::string& name, const RenderTarget& target);
+
+    void addPass(const std::string& name, const std::vector<RenderResource>& reads,
+                 const std::vector<RenderResource>& writes, PassFunction execute);
+
+    void compile();
+    void execute();
+
+    const RenderTargetDesc& getDesc(RenderResource resource) const;
+    // @brief Returns the target backing a resource. Only valid while the graph is executing.
+    const RenderTarget& getTarget(RenderResource resource) const;
+
+    size_t getPassCount() const;
+    size_t getCulledPassCount() const;
+    size_t getTransientTargetCount() const;
+
+private:
+    struct Resource
+    {
+        std::string name;
+        RenderTargetDesc desc;
+        const RenderTarget* imported = nullptr;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        std::string group;
+        std::vector<RenderResource> reads;
+        std::vector<RenderResource> writes;
+        PassFunction execute;
+    };
+
+    // A physical target shared by transient resources, and the range of compiled passes it is needed for.
+    struct Slot
+    {
+        RenderTargetDesc desc;
+        size_t firstUse = 0;
+        size_t lastUse = 0;
+    };
+
+    RenderTargetManager& targets;
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::string group;
+    GpuProfiler* profiler = nullptr;
+
+    // Compiled state, reused while the hash of the declared graph stays the same.
+    uint64_t compiledHash = 0;
+    bool compiled = false;
+    size_t culledCount = 0;
+    std::vector<size_t> order;
+    std::vector<Slot> slots;
+    std::vector<size_t> resourceSlots;
+    std::vector<const RenderTarget*> slotTargets;
+
+    uint64_t hash() const;
+    bool writes(const Pass& pass, RenderResource resource) const;
+    std::vector<bool> cull() const;
+    std::vector<size_t> sort(const std::vector<bool>& live) const;
+    void allocate();
+};
+
+#endif //KUMIGAME_RENDERER_RENDER_GRAPH_HPP
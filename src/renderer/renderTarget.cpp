@@ -0,0 +1,236 @@
+#include "renderTarget.hpp"
+#include "../debug/log.hpp"
+#include "../debug/memoryTracker.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <string>
+
+bool RenderTargetDesc::operator==(const RenderTargetDesc& other) const
+{
+    return size == other.size && colorFormat == other.colorFormat && depthFormat == other.depthFormat &&
+           samples == other.samples && velocityFormat == other.velocityFormat;
+}
+
+bool RenderTargetDesc::operator!=(const RenderTargetDesc& other) const
+{
+    return !(*this == other);
+}
+
+RenderTargetManager::RenderTargetManager(double resizeDelay, unsigned int poolIdleFrames)
+    : resizeDelay(resizeDelay), poolIdleFrames(poolIdleFrames)
+{
+}
+
+RenderTargetManager::~RenderTargetManager()
+{
+    for (auto& [name, named] : targets)
+    {
+        destroy(named.target);
+    }
+    for (auto& pooled : pool)
+    {
+        destroy(*pooled.target);
+    }
+}
+
+void RenderTargetManager::beginFrame(double currentTime)
+{
+    time = currentTime;
+    frame++;
+}
+
+void RenderTargetManager::endFrame()
+{
+    // Free transient targets that have not been used for a while.
+    pool.erase(std::remove_if(pool.begin(), pool.end(), [this](PooledTarget& pooled) {
+        if (!pooled.inUse && frame - pooled.lastUsedFrame > poolIdleFrames)
+        {
+            destroy(*pooled.target);
+            return true;
+        }
+        return false;
+    }), pool.end());
+}
+
+const RenderTarget& RenderTargetManager::getTarget(const std::string& name, const RenderTargetDesc& desc)
+{
+    auto it = targets.find(name);
+    if (it == targets.end())
+    {
+        NamedTarget named = {
+            .target = create(desc),
+            .pending = desc,
+            .pendingSince = time
+        };
+        return targets.emplace(name, named).first->second.target;
+    }
+
+    NamedTarget& named = it->second;
+    if (named.target.desc == desc || desc.size.x <= 0 || desc.size.y <= 0)
+    {
+        named.pending = named.target.desc;
+        return named.target;
+    }
+
+    // Restart the debounce timer whenever the requested description changes.
+    if (named.pending != desc)
+    {
+        named.pending = desc;
+        named.pendingSince = time;
+    }
+
+    // Format changes are applied immediately, size changes once the size has settled.
+    bool formatChanged = named.target.desc.colorFormat != desc.colorFormat ||
+                         named.target.desc.depthFormat != desc.depthFormat ||
+                         named.target.desc.samples != desc.samples ||
+                         named.target.desc.velocityFormat != desc.velocityFormat;
+    if (formatChanged || time - named.pendingSince >= resizeDelay)
+    {
+        LOG_DEBUG("Recreating render target \"{}\" ({}x{}).", name, desc.size.x, desc.size.y);
+        destroy(named.target);
+        named.target = create(desc);
+    }
+
+    return named.target;
+}
+
+void RenderTargetManager::releaseTarget(const std::string& name)
+{
+    auto it = targets.find(name);
+    if (it != targets.end())
+    {
+        destroy(it->second.target);
+        targets.erase(it);
+    }
+}
+
+const RenderTarget* RenderTargetManager::acquire(const RenderTargetDesc& desc)
+{
+    for (auto& pooled : pool)
+    {
+        if (!pooled.inUse && pooled.target->desc == desc)
+        {
+            pooled.inUse = true;
+            pooled.lastUsedFrame = frame;
+            return pooled.target.get();
+        }
+    }
+
+    PooledTarget pooled = {
+        .target = std::make_unique<RenderTarget>(create(desc)),
+        .inUse = true,
+        .lastUsedFrame = frame
+    };
+    pool.push_back(std::move(pooled));
+    return pool.back().target.get();
+}
+
+void RenderTargetManager::release(const RenderTarget* target)
+{
+    for (auto& pooled : pool)
+    {
+        if (pooled.target.get() == target)
+        {
+            pooled.inUse = false;
+            pooled.lastUsedFrame = frame;
+            return;
+        }
+    }
+
+    LOG_WARN("Released a render target that does not belong to the pool.");
+}
+
+RenderTarget RenderTargetManager::create(const RenderTargetDesc& desc)
+{
+    RenderTarget target;
+    target.desc = desc;
+
+    glGenFramebuffers(1, &target.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+
+    if (desc.samples > 0)
+    {
+        // Multisample targets are only rendered to and resolved with a blit, so a renderbuffer is enough.
+        glGenRenderbuffers(1, &target.colorRenderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.colorRenderbuffer);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, desc.samples, desc.colorFormat, desc.size.x, desc.size.y);
+        MemoryTracker::trackRenderbuffer(target.colorRenderbuffer, MemoryCategory::RenderTarget,
+                                         MemoryTracker::textureSize(desc.colorFormat, desc.size.x, desc.size.y, 1, desc.samples));
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.colorRenderbuffer);
+    }
+    else
+    {
+        // Immutable storage so the driver never has to handle a respecification.
+        glGenTextures(1, &target.colorTexture);
+        glBindTexture(GL_TEXTURE_2D, target.colorTexture);
+        glTexStorage2D(GL_TEXTURE_2D, 1, desc.colorFormat, desc.size.x, desc.size.y);
+        MemoryTracker::trackTexture(target.colorTexture, MemoryCategory::RenderTarget,
+                                    MemoryTracker::textureSize(desc.colorFormat, desc.size.x, desc.size.y));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.colorTexture, 0);
+
+        if (desc.velocityFormat != GL_NONE)
+        {
+            glGenTextures(1, &target.velocityTexture);
+            glBindTexture(GL_TEXTURE_2D, target.velocityTexture);
+            glTexStorage2D(GL_TEXTURE_2D, 1, desc.velocityFormat, desc.size.x, desc.size.y);
+            MemoryTracker::trackTexture(target.velocityTexture, MemoryCategory::RenderTarget,
+                                        MemoryTracker::textureSize(desc.velocityFormat, desc.size.x, desc.size.y));
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, target.velocityTexture, 0);
+
+            const GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+            glDrawBuffers(2, drawBuffers);
+        }
+    }
+
+    if (desc.depthFormat != GL_NONE)
+    {
+        glGenRenderbuffers(1, &target.depthRenderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.depthRenderbuffer);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, desc.samples, desc.depthFormat, desc.size.x, desc.size.y);
+        MemoryTracker::trackRenderbuffer(target.depthRenderbuffer, MemoryCategory::RenderTarget,
+                                         MemoryTracker::textureSize(desc.depthFormat, desc.size.x, desc.size.y, 1, desc.samples));
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depthRenderbuffer);
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        LOG_ERROR("Framebuffer is not complete!");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return target;
+}
+
+void RenderTargetManager::destroy(RenderTarget& target)
+{
+    glDeleteFramebuffers(1, &target.fbo);
+    if (target.colorTexture)
+    {
+        MemoryTracker::releaseTexture(target.colorTexture);
+        glDeleteTextures(1, &target.colorTexture);
+    }
+    if (target.velocityTexture)
+    {
+        MemoryTracker::releaseTexture(target.velocityTexture);
+        glDeleteTextures(1, &target.velocityTexture);
+    }
+    if (target.colorRenderbuffer)
+    {
+        MemoryTracker::releaseRenderbuffer(target.colorRenderbuffer);
+        glDeleteRenderbuffers(1, &target.colorRenderbuffer);
+    }
+    if (target.depthRenderbuffer)
+    {
+        MemoryTracker::releaseRenderbuffer(target.depthRenderbuffer);
+        glDeleteRenderbuffers(1, &target.depthRenderbuffer);
+    }
+    target = RenderTarget();
+}
@@ -0,0 +1,89 @@
+#ifndef KUMIGAME_RENDERER_RENDER_TARGET_HPP
+#define KUMIGAME_RENDERER_RENDER_TARGET_HPP
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct RenderTargetDesc
+{
+    glm::ivec2 size{};
+    GLenum colorFormat = GL_RGBA8;
+    GLenum depthFormat = GL_NONE;
+    // When non-zero the color attachment is a multisample renderbuffer instead of a texture.
+    GLsizei samples = 0;
+    // Adds a second color attachment for per-pixel motion vectors. Only supported without multisampling.
+    GLenum velocityFormat = GL_NONE;
+
+    bool operator==(const RenderTargetDesc& other) const;
+    bool operator!=(const RenderTargetDesc& other) const;
+};
+
+struct RenderTarget
+{
+    GLuint fbo = 0;
+    GLuint colorTexture = 0;
+    GLuint colorRenderbuffer = 0;
+    GLuint velocityTexture = 0;
+    GLuint depthRenderbuffer = 0;
+    RenderTargetDesc desc;
+};
+
+/**
+ * @brief Owns framebuffers and their attachments.
+ *
+ * Named targets persist across frames and are only recreated when their description changes. Size changes are
+ * debounced so that dragging the window edge does not reallocate every frame. Transient targets are pooled by
+ * description and handed out with acquire()/release().
+ */
+class RenderTargetManager
+{
+public:
+    explicit RenderTargetManager(double resizeDelay = 0.2, unsigned int poolIdleFrames = 120);
+    ~RenderTargetManager();
+
+    RenderTargetManager(const RenderTargetManager&) = delete;
+    RenderTargetManager& operator=(const RenderTargetManager&) = delete;
+
+    void beginFrame(double time);
+    void endFrame();
+
+    // @brief Returns the named target, creating or recreating it when needed.
+    const RenderTarget& getTarget(const std::string& name, const RenderTargetDesc& desc);
+    // @brief Destroys the named target if it exists.
+    void releaseTarget(const std::string& name);
+    // @brief Returns an unused pooled target matching the description.
+    const RenderTarget* acquire(const RenderTargetDesc& desc);
+    // @brief Returns a target obtained from acquire() to the pool.
+    void release(const RenderTarget* target);
+
+private:
+    struct NamedTarget
+    {
+        RenderTarget target;
+        RenderTargetDesc pending;
+        double pendingSince = 0.0;
+    };
+
+    struct PooledTarget
+    {
+        std::unique_ptr<RenderTarget> target;
+        bool inUse = false;
+        unsigned long long lastUsedFrame = 0;
+    };
+
+    double resizeDelay;
+    unsigned int poolIdleFrames;
+    double time = 0.0;
+    unsigned long long frame = 0;
+    std::map<std::string, NamedTarget> targets;
+    std::vector<PooledTarget> pool;
+
+    static RenderTarget create(const RenderTargetDesc& desc);
+    static void destroy(RenderTarget& target);
+};
+
+#endif //KUMIGAME_RENDERER_RENDER_TARGET_HPP
@@ -1,5 +1,6 @@
 #include "shader.hpp"
 #include "../debug/log.hpp"
+#include "../debug/profiler.hpp"
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <fstream>
@@ -96,6 +97,8 @@ void Shader::stop()
 void Shader::loadFromFile(
         const GLchar* vertexShaderFile, const GLchar* fragmentShaderFile, const GLchar* geometryShaderFile)
 {
+    PROFILE_SCOPE("Shader::loadFromFile");
+
     std::stringstream geomLoadText;
     if (geometryShaderFile)
     {
@@ -146,6 +149,8 @@ void Shader::loadFromFile(
 
 void Shader::compile(const GLchar* vertexSource, const GLchar* fragmentSource, const GLchar* geometrySource)
 {
+    PROFILE_SCOPE("Shader::compile");
+
     GLuint vertexShader = 0;
     GLuint fragmentShader = 0;
     GLuint geometryShader = 0;
@@ -187,6 +192,43 @@ void Shader::compile(const GLchar* vertexSource, const GLchar* fragmentSource, c
         glDeleteShader(geometryShader);
 }
 
+void Shader::loadComputeFromFile(const GLchar* computeShaderFile)
+{
+    std::string computeCode;
+
+    try
+    {
+        std::ifstream cShaderFile(computeShaderFile);
+        std::stringstream cShaderStream;
+        cShaderStream << cShaderFile.rdbuf();
+        cShaderFile.close();
+        computeCode = cShaderStream.str();
+    }
+    catch (const std::exception &e)
+    {
+        LOG_ERROR("Failed to read shader file:\n\t{}", e.what());
+    }
+
+    compileCompute(computeCode.c_str());
+}
+
+void Shader::compileCompute(const GLchar* computeSource)
+{
+    // Compute Shader
+    GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(computeShader, 1, &computeSource, nullptr);
+    glCompileShader(computeShader);
+    checkCompileErrors(computeShader, "COMPUTE");
+
+    // Shader Program
+    id = glCreateProgram();
+    glAttachShader(id, computeShader);
+    glLinkProgram(id);
+    checkCompileErrors(id, "PROGRAM");
+
+    glDeleteShader(computeShader);
+}
+
 void checkCompileErrors(GLuint object, const std::string& type)
 {
     GLint success;
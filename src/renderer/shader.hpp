@@ -35,6 +35,8 @@ public:
     void stop();
     void loadFromFile(const GLchar* vertexShaderFile, const GLchar* fragmentShaderFile, const GLchar* geometryShaderFile);
     void compile(const GLchar* vertexSource, const GLchar* fragmentSource, const GLchar* geometrySource = nullptr);
+    void loadComputeFromFile(const GLchar* computeShaderFile);
+    void compileCompute(const GLchar* computeSource);
 
 private:
     static std::vector<std::shared_ptr<Shader>> shaders;
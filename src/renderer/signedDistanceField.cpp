@@ -0,0 +1,125 @@
+#include "signedDistanceField.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    const float INF = 1e20f;
+
+    // Squared distance transform of one row or column, in place. Uses the lower envelope of parabolas rooted at
+    // every sample.
+    void transform1d(std::vector<float>& values, std::vector<float>& result, std::vector<int>& roots,
+                     std::vector<float>& boundaries, int count)
+    {
+        int k = 0;
+        roots[0] = 0;
+        boundaries[0] = -INF;
+        boundaries[1] = INF;
+        for (int q = 1; q < count; ++q)
+        {
+            float s;
+            while (true)
+            {
+                int r = roots[k];
+                s = ((values[q] + static_cast<float>(q * q)) - (values[r] + static_cast<float>(r * r))) /
+                    static_cast<float>(2 * q - 2 * r);
+                if (s > boundaries[k] || k == 0)
+                {
+                    break;
+                }
+                k--;
+            }
+            if (s <= boundaries[k])
+            {
+                // Only reachable with k == 0: the new parabola dominates everywhere.
+                roots[0] = q;
+                boundaries[0] = -INF;
+                boundaries[1] = INF;
+                continue;
+            }
+            k++;
+            roots[k] = q;
+            boundaries[k] = s;
+            boundaries[k + 1] = INF;
+        }
+
+        k = 0;
+        for (int q = 0; q < count; ++q)
+        {
+            while (boundaries[k + 1] < static_cast<float>(q))
+            {
+                k++;
+            }
+            int r = roots[k];
+            result[q] = static_cast<float>((q - r) * (q - r)) + values[r];
+        }
+    }
+
+    // Squared distance from every texel to the nearest texel marked zero in the grid.
+    void transform2d(std::vector<float>& grid, int width, int height)
+    {
+        int length = std::max(width, height);
+        std::vector<float> values(length);
+        std::vector<float> result(length);
+        std::vector<int> roots(length);
+        std::vector<float> boundaries(length + 1);
+
+        for (int x = 0; x < width; ++x)
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                values[y] = grid[y * width + x];
+            }
+            transform1d(values, result, roots, boundaries, height);
+            for (int y = 0; y < height; ++y)
+            {
+                grid[y * width + x] = result[y];
+            }
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            std::copy(grid.begin() + y * width, grid.begin() + (y + 1) * width, values.begin());
+            transform1d(values, result, roots, boundaries, width);
+            std::copy(result.begin(), result.begin() + width, grid.begin() + y * width);
+        }
+    }
+}
+
+std::vector<uint8_t> generateSignedDistanceField(const uint8_t* coverage, int width, int height, int pitch, int spread)
+{
+    int paddedWidth = width + 2 * spread;
+    int paddedHeight = height + 2 * spread;
+    auto size = static_cast<size_t>(paddedWidth * paddedHeight);
+
+    // Distance to the nearest inside texel for outside texels, and to the nearest outside texel for inside texels.
+    std::vector<float> toInside(size, INF);
+    std::vector<float> toOutside(size, 0.0f);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (coverage[y * pitch + x] >= 128)
+            {
+                size_t index = static_cast<size_t>((y + spread) * paddedWidth + x + spread);
+                toInside[index] = 0.0f;
+                toOutside[index] = INF;
+            }
+        }
+    }
+
+    transform2d(toInside, paddedWidth, paddedHeight);
+    transform2d(toOutside, paddedWidth, paddedHeight);
+
+    std::vector<uint8_t> field(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        // Texel centres on either side of the outline are half a texel from it.
+        float distance = toOutside[i] > 0.0f ? std::sqrt(toOutside[i]) - 0.5f : 0.5f - std::sqrt(toInside[i]);
+        float value = 0.5f + 0.5f * distance / static_cast<float>(spread);
+        field[i] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    return field;
+}
@@ -0,0 +1,16 @@
+#ifndef KUMIGAME_RENDERER_SIGNED_DISTANCE_FIELD_HPP
+#define KUMIGAME_RENDERER_SIGNED_DISTANCE_FIELD_HPP
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Converts a coverage bitmap into a signed distance field.
+ *
+ * The result is padded by spread texels on every side. A value of 0.5 (128) lies on the outline, larger values are
+ * inside, and the distance saturates spread texels away from the outline. Distances are exact Euclidean distances
+ * between texel centres, computed with the separable transform of Felzenszwalb and Huttenlocher.
+ */
+std::vector<uint8_t> generateSignedDistanceField(const uint8_t* coverage, int width, int height, int pitch, int spread);
+
+#endif //KUMIGAME_RENDERER_SIGNED_DISTANCE_FIELD_HPP
@@ -0,0 +1,118 @@
+#include "skylinePacker.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+SkylinePacker::SkylinePacker(glm::ivec2 size)
+    : size(size)
+{
+    clear();
+}
+
+std::optional<glm::ivec2> SkylinePacker::insert(glm::ivec2 rectangle)
+{
+    if (rectangle.x <= 0 || rectangle.y <= 0)
+    {
+        return glm::ivec2(0);
+    }
+
+    int bestY = std::numeric_limits<int>::max();
+    int bestWidth = std::numeric_limits<int>::max();
+    size_t bestIndex = skyline.size();
+    for (size_t i = 0; i < skyline.size(); ++i)
+    {
+        if (auto y = fit(i, rectangle))
+        {
+            if (y.value() < bestY || (y.value() == bestY && skyline[i].width < bestWidth))
+            {
+                bestY = y.value();
+                bestWidth = skyline[i].width;
+                bestIndex = i;
+            }
+        }
+    }
+
+    if (bestIndex == skyline.size())
+    {
+        return {};
+    }
+
+    glm::ivec2 position(skyline[bestIndex].x, bestY);
+    addSegment(bestIndex, position, rectangle);
+    return position;
+}
+
+void SkylinePacker::clear()
+{
+    skyline.clear();
+    skyline.push_back({ 0, 0, size.x });
+}
+
+glm::ivec2 SkylinePacker::getSize() const
+{
+    return size;
+}
+
+std::optional<int> SkylinePacker::fit(size_t index, glm::ivec2 rectangle) const
+{
+    // The rectangle rests on the highest segment it spans.
+    int x = skyline[index].x;
+    if (x + rectangle.x > size.x)
+    {
+        return {};
+    }
+
+    int y = 0;
+    int remaining = rectangle.x;
+    for (size_t i = index; remaining > 0; ++i)
+    {
+        y = std::max(y, skyline[i].y);
+        if (y + rectangle.y > size.y)
+        {
+            return {};
+        }
+        remaining -= skyline[i].width;
+    }
+
+    return y;
+}
+
+void SkylinePacker::addSegment(size_t index, glm::ivec2 position, glm::ivec2 rectangle)
+{
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(index),
+                   { position.x, position.y + rectangle.y, rectangle.x });
+
+    // Shrink or remove the segments now covered by the new one.
+    int right = position.x + rectangle.x;
+    for (size_t i = index + 1; i < skyline.size();)
+    {
+        Segment& segment = skyline[i];
+        if (segment.x >= right)
+        {
+            break;
+        }
+
+        int overlap = right - segment.x;
+        if (overlap < segment.width)
+        {
+            segment.x += overlap;
+            segment.width -= overlap;
+            break;
+        }
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // Merge neighbouring segments at the same height.
+    for (size_t i = 0; i + 1 < skyline.size();)
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i) + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef KUMIGAME_RENDERER_SKYLINE_PACKER_HPP
+#define KUMIGAME_RENDERER_SKYLINE_PACKER_HPP
+
+#include <glm/glm.hpp>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Packs rectangles into a fixed-size area, tracking the top edge of the packed rectangles as a skyline.
+ *
+ * Each rectangle is placed where it ends up lowest, ties broken by the narrowest segment. The space below
+ * overhanging rectangles is never reused, which wastes little when rectangles have similar heights, as glyphs do.
+ */
+class SkylinePacker
+{
+public:
+    explicit SkylinePacker(glm::ivec2 size);
+
+    // @brief Returns the bottom-left corner of the placed rectangle, or nothing if it does not fit.
+    std::optional<glm::ivec2> insert(glm::ivec2 rectangle);
+    // @brief Forgets every placed rectangle.
+    void clear();
+    glm::ivec2 getSize() const;
+
+private:
+    struct Segment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    glm::ivec2 size;
+    std::vector<Segment> skyline;
+
+    std::optional<int> fit(size_t index, glm::ivec2 rectangle) const;
+    void addSegment(size_t index, glm::ivec2 position, glm::ivec2 rectangle);
+};
+
+#endif //KUMIGAME_RENDERER_SKYLINE_PACKER_HPP
@@ -0,0 +1,123 @@
+#include "temporalUpscaler.hpp"
+#include <algorithm>
+
+namespace
+{
+    const char* HISTORY_TARGETS[2] = { "temporalHistory0", "temporalHistory1" };
+    const unsigned int MIN_JITTER_PHASES = 8;
+    const unsigned int MAX_JITTER_PHASES = 32;
+
+    float halton(unsigned int index, unsigned int base)
+    {
+        float fraction = 1.0f;
+        float result = 0.0f;
+        while (index > 0)
+        {
+            fraction /= static_cast<float>(base);
+            result += fraction * static_cast<float>(index % base);
+            index /= base;
+        }
+        return result;
+    }
+}
+
+TemporalUpscaler::TemporalUpscaler(GLuint quadVAO)
+    : quadVAO(quadVAO)
+{
+    shader = std::make_shared<Shader>("assets/shaders/screen.vert", "assets/shaders/temporal.frag");
+}
+
+void TemporalUpscaler::beginFrame(glm::ivec2 renderSize, glm::ivec2 outputSize)
+{
+    sceneSize = renderSize;
+    frame++;
+
+    // Each output pixel needs about eight samples, and every scene texel covers several output pixels when upscaling.
+    float ratio = static_cast<float>(outputSize.x) / static_cast<float>(std::max(sceneSize.x, 1));
+    auto phases = static_cast<unsigned int>(static_cast<float>(MIN_JITTER_PHASES) * ratio * ratio);
+    phases = std::clamp(phases, MIN_JITTER_PHASES, MAX_JITTER_PHASES);
+
+    // Halton indices start at 1; index 0 would always be the texel corner.
+    unsigned int index = frame % phases + 1;
+    jitterOffset = glm::vec2(halton(index, 2) - 0.5f, halton(index, 3) - 0.5f);
+}
+
+glm::mat4 TemporalUpscaler::jitter(const glm::mat4& projection) const
+{
+    // Offsetting the third column shifts the projected image by a constant amount in normalized device coordinates.
+    glm::mat4 jittered = projection;
+    jittered[2][0] += jitterOffset.x * 2.0f / static_cast<float>(sceneSize.x);
+    jittered[2][1] += jitterOffset.y * 2.0f / static_cast<float>(sceneSize.y);
+    return jittered;
+}
+
+RenderResource TemporalUpscaler::addPass(RenderGraph& graph, RenderTargetManager& targets, RenderResource scene,
+                                         glm::ivec2 outputSize)
+{
+    RenderTargetDesc desc = {
+        .size = outputSize,
+        .colorFormat = GL_RGBA16F
+    };
+    const RenderTarget& previous = targets.getTarget(HISTORY_TARGETS[(frame + 1) % 2], desc);
+    const RenderTarget& current = targets.getTarget(HISTORY_TARGETS[frame % 2], desc);
+
+    // Both targets are resized in the same frame; the history is unusable for that frame.
+    bool valid = historyValid && previous.desc.size == current.desc.size && previous.desc.size == historySize;
+    historySize = current.desc.size;
+    historyValid = true;
+
+    outputViewport = glm::min(outputSize, current.desc.size);
+    glm::vec2 historyTargetSize = glm::vec2(previous.desc.size);
+    glm::vec2 historyUvScale = glm::vec2(outputViewport) / historyTargetSize;
+    glm::vec2 historyUvMax = (glm::vec2(outputViewport) - 0.5f) / historyTargetSize;
+    float weight = valid ? historyWeight : 0.0f;
+
+    RenderResource history = graph.importTarget("temporalHistory", previous);
+    RenderResource output = graph.importTarget("temporalOutput", current);
+    graph.addPass("temporal", { scene, history }, { output },
+                  [this, scene, history, output, historyUvScale, historyUvMax, weight](const RenderGraph& graph) {
+        glBindFramebuffer(GL_FRAMEBUFFER, graph.getTarget(output).fbo);
+        glViewport(0, 0, outputViewport.x, outputViewport.y);
+
+        shader->use();
+        shader->setInteger("Scene", 0);
+        shader->setInteger("Velocity", 1);
+        shader->setInteger("History", 2);
+        shader->setVector2f("RenderSize", glm::vec2(sceneSize));
+        shader->setVector2f("Jitter", jitterOffset);
+        shader->setVector2f("HistoryUvScale", historyUvScale);
+        shader->setVector2f("HistoryUvMax", historyUvMax);
+        shader->setFloat("HistoryWeight", weight);
+
+        const RenderTarget& sceneTarget = graph.getTarget(scene);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, sceneTarget.colorTexture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, sceneTarget.velocityTexture);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, graph.getTarget(history).colorTexture);
+
+        glBindVertexArray(quadVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glActiveTexture(GL_TEXTURE0);
+    });
+
+    return output;
+}
+
+glm::ivec2 TemporalUpscaler::getOutputViewport() const
+{
+    return outputViewport;
+}
+
+void TemporalUpscaler::invalidate()
+{
+    historyValid = false;
+}
+
+void TemporalUpscaler::release(RenderTargetManager& targets)
+{
+    targets.releaseTarget(HISTORY_TARGETS[0]);
+    targets.releaseTarget(HISTORY_TARGETS[1]);
+    historyValid = false;
+}
@@ -0,0 +1,51 @@
+#ifndef KUMIGAME_RENDERER_TEMPORAL_UPSCALER_HPP
+#define KUMIGAME_RENDERER_TEMPORAL_UPSCALER_HPP
+
+#include "renderGraph.hpp"
+#include "renderTarget.hpp"
+#include "shader.hpp"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+
+/**
+ * @brief Reconstructs a full resolution image from a scene rendered at a lower resolution over several frames.
+ *
+ * The projection is offset by a different sub-pixel amount every frame, following a Halton sequence. Each frame the
+ * previous output is reprojected with the scene's motion vectors, clamped to the neighbourhood of the new sample and
+ * blended with it. The history is kept in two targets at output resolution that swap roles every frame.
+ */
+class TemporalUpscaler
+{
+public:
+    // Weight of the history for a sample centred on the output pixel.
+    float historyWeight = 0.9f;
+
+    explicit TemporalUpscaler(GLuint quadVAO);
+
+    // @brief Advances the jitter sequence. Call once per frame before building the projection.
+    void beginFrame(glm::ivec2 renderSize, glm::ivec2 outputSize);
+    // @brief Returns the projection offset by this frame's jitter.
+    glm::mat4 jitter(const glm::mat4& projection) const;
+    // @brief Adds the reconstruction pass and returns the resource holding the output.
+    RenderResource addPass(RenderGraph& graph, RenderTargetManager& targets, RenderResource scene,
+                           glm::ivec2 outputSize);
+    // @brief Returns the part of the output target written by the last addPass().
+    glm::ivec2 getOutputViewport() const;
+    // @brief Discards the history so the next frame only uses its own samples.
+    void invalidate();
+    // @brief Destroys the history targets.
+    void release(RenderTargetManager& targets);
+
+private:
+    GLuint quadVAO;
+    std::shared_ptr<Shader> shader;
+    unsigned int frame = 0;
+    glm::vec2 jitterOffset{};
+    glm::ivec2 sceneSize{};
+    glm::ivec2 outputViewport{};
+    glm::ivec2 historySize{};
+    bool historyValid = false;
+};
+
+#endif //KUMIGAME_RENDERER_TEMPORAL_UPSCALER_HPP
@@ -1,14 +1,43 @@
 #include "textRenderer.hpp"
 #include "shader.hpp"
+#include "signedDistanceField.hpp"
 #include "../debug/log.hpp"
+#include "../debug/memoryTracker.hpp"
+#include "../util/string.hpp"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 
 TextRenderer::TextRenderer(GLuint width, GLuint height, std::shared_ptr<Shader> &shader, const std::string& fontPath, GLuint fontSize)
 {
+    MemoryScope memoryScope(MemoryCategory::Font);
     initRenderDescriptor(width, height, shader);
     loadFont(fontPath, fontSize);
 }
 
+TextRenderer::~TextRenderer()
+{
+    MemoryTracker::releaseTexture(atlas);
+    MemoryTracker::releaseBuffer(layoutBuffer);
+    MemoryTracker::releaseBuffer(instanceBuffer);
+    MemoryTracker::releaseBuffer(commandBuffer);
+    glDeleteTextures(1, &atlas);
+    glDeleteBuffers(1, &layoutBuffer);
+    glDeleteBuffers(1, &instanceBuffer);
+    glDeleteBuffers(1, &commandBuffer);
+    glDeleteVertexArrays(1, &vao);
+
+    if (face)
+    {
+        FT_Done_Face(face);
+    }
+    if (library)
+    {
+        FT_Done_FreeType(library);
+    }
+}
+
 void TextRenderer::initRenderDescriptor(GLuint width, GLuint height, std::shared_ptr<Shader> &textShader)
 {
     shader = textShader;
@@ -19,180 +48,457 @@ void TextRenderer::initRenderDescriptor(GLuint width, GLuint height, std::shared
     shader->setInteger("Text", 0);
 
     glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &layoutBuffer);
+    glGenBuffers(1, &instanceBuffer);
+    glGenBuffers(1, &commandBuffer);
     glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
+
+    // Glyph quads of the cached layouts; position and texture coordinates are read together as one vec4.
+    glBindBuffer(GL_ARRAY_BUFFER, layoutBuffer);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, page));
+
+    // Color and position of each drawn string, selected by the base instance of its draw command.
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, offset));
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+
+    layoutCapacity = INITIAL_LAYOUT_CAPACITY;
+    uploadLayouts();
 }
 
 void TextRenderer::loadFont(const std::string& fontPath, GLuint fontSize)
 {
-    characters.clear();
+    characters = {};
 
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft))
+    if (FT_Init_FreeType(&library))
     {
         LOG_ERROR("FreeType: Could not initialize FreeType!");
+        library = nullptr;
+        return;
     }
 
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face))
+    if (FT_New_Face(library, fontPath.c_str(), 0, &face))
     {
         LOG_ERROR("FreeType: Failed to load font!");
+        face = nullptr;
+        return;
+    }
+
+    // Glyphs are always rasterized at the same size and scaled when drawn.
+    FT_Set_Pixel_Sizes(face, 0, SDF_SIZE);
+    fontScale = static_cast<float>(fontSize) / static_cast<float>(SDF_SIZE);
+
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_R8, ATLAS_SIZE, ATLAS_SIZE, ATLAS_PAGES);
+    MemoryTracker::trackTexture(atlas, MemoryCategory::Font,
+                                MemoryTracker::textureSize(GL_R8, ATLAS_SIZE, ATLAS_SIZE, ATLAS_PAGES));
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    pages.clear();
+    for (GLuint page = 0; page < ATLAS_PAGES; ++page)
+    {
+        pages.push_back({ SkylinePacker(glm::ivec2(ATLAS_SIZE, ATLAS_SIZE)), {}, 0 });
+        evictPage(page);
+    }
+
+    // ASCII goes into the first page, which allocateGlyph() fills first and evictPage() is never asked to clear.
+    for (char32_t c = 0; c < characters.size(); ++c)
+    {
+        if (!loadGlyph(c, characters[c]))
+        {
+            characters[c].size = glm::ivec2(0);
+        }
     }
+}
 
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
+bool TextRenderer::loadGlyph(char32_t codePoint, Character& character)
+{
+    if (!face || FT_Load_Char(face, codePoint, FT_LOAD_RENDER))
+    {
+        LOG_ERROR("FreeType: Failed to load glyph {}!", static_cast<uint32_t>(codePoint));
+        return false;
+    }
 
+    FT_Bitmap& bitmap = face->glyph->bitmap;
+    glm::ivec2 size(bitmap.width, bitmap.rows);
+    character.size = size;
+    character.bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+    character.advance = face->glyph->advance.x;
+    character.page = 0;
+    character.uvMin = glm::vec2(0.0f);
+    character.uvMax = glm::vec2(0.0f);
+    if (size.x == 0 || size.y == 0)
+    {
+        return true;
+    }
+
+    glm::ivec2 fieldSize = size + 2 * SDF_SPREAD;
+    auto position = allocateGlyph(fieldSize + 2 * GLYPH_PADDING, character.page);
+    if (!position)
+    {
+        LOG_WARN("FreeType: Glyph atlas is full, glyph {} will not be drawn.", static_cast<uint32_t>(codePoint));
+        return false;
+    }
+
+    std::vector<uint8_t> field = generateSignedDistanceField(bitmap.buffer, size.x, size.y, bitmap.pitch, SDF_SPREAD);
+    glm::ivec2 origin = position.value() + GLYPH_PADDING;
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, origin.x, origin.y, static_cast<GLint>(character.page),
+                    fieldSize.x, fieldSize.y, 1, GL_RED, GL_UNSIGNED_BYTE, field.data());
+    character.uvMin = glm::vec2(origin) / static_cast<float>(ATLAS_SIZE);
+    character.uvMax = glm::vec2(origin + fieldSize) / static_cast<float>(ATLAS_SIZE);
+
+    pages[character.page].glyphs.push_back(codePoint);
+    pages[character.page].lastUsedFrame = frame;
+    return true;
+}
+
+const Character& TextRenderer::getCharacter(char32_t codePoint)
+{
+    if (codePoint < characters.size())
+    {
+        return characters[codePoint];
+    }
+
+    auto it = glyphs.find(codePoint);
+    if (it != glyphs.end())
+    {
+        pages[it->second.page].lastUsedFrame = frame;
+        return it->second;
+    }
 
-    for (GLubyte c = 0; c < 128; ++c)
+    Character character{};
+    if (!loadGlyph(codePoint, character))
     {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+        return characters['?'];
+    }
+    return glyphs.emplace(codePoint, character).first->second;
+}
+
+std::optional<glm::ivec2> TextRenderer::allocateGlyph(glm::ivec2 size, GLuint& page)
+{
+    for (page = 0; page < pages.size(); ++page)
+    {
+        if (auto position = pages[page].packer.insert(size))
         {
-            LOG_ERROR("FreeType: Failed to load glyph!");
+            return position;
         }
+    }
+
+    // Reuse the least recently drawn page, unless it holds glyphs already drawn this frame.
+    GLuint oldest = 0;
+    for (GLuint i = 1; i < pages.size(); ++i)
+    {
+        if (oldest == 0 || pages[i].lastUsedFrame < pages[oldest].lastUsedFrame)
+        {
+            oldest = i;
+        }
+    }
+    if (oldest == 0 || pages[oldest].lastUsedFrame >= frame)
+    {
+        return {};
+    }
+
+    evictPage(oldest);
+    page = oldest;
+    return pages[page].packer.insert(size);
+}
 
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows,
-                     0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
+void TextRenderer::evictPage(GLuint page)
+{
+    AtlasPage& atlasPage = pages[page];
+    for (char32_t codePoint : atlasPage.glyphs)
+    {
+        glyphs.erase(codePoint);
+    }
+    atlasPage.glyphs.clear();
+    atlasPage.packer.clear();
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Layouts drawing from the page would now show other glyphs; their space is reclaimed on the next compaction.
+    for (auto it = layouts.begin(); it != layouts.end();)
+    {
+        if (it->second.pages & (1u << page))
+        {
+            it = layouts.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
 
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
+    // Clear the page so the padding around glyphs is empty.
+    std::vector<GLubyte> empty(ATLAS_SIZE * ATLAS_SIZE, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(page), ATLAS_SIZE, ATLAS_SIZE, 1,
+                    GL_RED, GL_UNSIGNED_BYTE, empty.data());
+}
 
-        characters.insert(std::pair<GLchar, Character>(c, character));
+void TextRenderer::render(const std::string& text, glm::vec2 position, GLfloat scale, glm::vec4 color, bool rightToLeft)
+{
+    const Layout& layout = getLayout(text, scale, rightToLeft);
+    if (layout.count == 0)
+    {
+        return;
     }
 
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+    commands.push_back({
+        .count = layout.count,
+        .instanceCount = 1,
+        .first = layout.first,
+        .baseInstance = static_cast<GLuint>(instances.size())
+    });
+    instances.push_back({ .offset = position, .color = color });
 }
 
-void TextRenderer::render(std::string text, glm::vec2 position, GLfloat scale, glm::vec4 color, bool rightToLeft)
+void TextRenderer::flush()
 {
+    frame++;
+    if (commands.empty())
+    {
+        return;
+    }
+
+    // Orphan the previous storage so the driver does not wait for last frame's draw to finish reading it.
+    size_t instanceBytes = instances.size() * sizeof(Instance);
+    instanceCapacity = std::max(instanceCapacity, instanceBytes);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instanceCapacity), nullptr, GL_STREAM_DRAW);
+    MemoryTracker::trackBuffer(instanceBuffer, MemoryCategory::Font, instanceCapacity);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(instanceBytes), instances.data());
+
+    size_t commandBytes = commands.size() * sizeof(DrawCommand);
+    commandCapacity = std::max(commandCapacity, commandBytes);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commandCapacity), nullptr, GL_STREAM_DRAW);
+    MemoryTracker::trackBuffer(commandBuffer, MemoryCategory::Font, commandCapacity);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, static_cast<GLsizeiptr>(commandBytes), commands.data());
+
+    // Keep text on top and never draw it as wireframe or points.
+    int polygonMode;
+    glGetIntegerv(GL_POLYGON_MODE, &polygonMode);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDisable(GL_DEPTH_TEST);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     shader->use();
-    shader->setVector4f("TextColor", color);
     glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas);
     glBindVertexArray(vao);
+    glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, static_cast<GLsizei>(commands.size()), 0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 
-    float lineHeight = characters['H'].size.y;
-    float xStart = position.x;
+    glDisable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+    glPolygonMode(GL_FRONT_AND_BACK, polygonMode);
 
-    if (rightToLeft)
-    {
-        auto newLineCount = std::count(text.begin(), text.end(), '\n');
-        position.y += newLineCount * lineHeight * scale * 2.0f;
+    commands.clear();
+    instances.clear();
+}
 
-        for (auto c = text.rbegin(); c != text.rend(); ++c)
-        {
-            Character ch = characters[*c];
+bool TextRenderer::LayoutKey::operator==(const LayoutKey& other) const
+{
+    return scale == other.scale && rightToLeft == other.rightToLeft && text == other.text;
+}
 
-            if (*c == '\n')
+size_t TextRenderer::LayoutKeyHash::operator()(const LayoutKey& key) const
+{
+    size_t hash = std::hash<std::string>()(key.text);
+    hash ^= std::hash<float>()(key.scale) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash ^ static_cast<size_t>(key.rightToLeft);
+}
+
+const TextRenderer::Layout& TextRenderer::getLayout(const std::string& text, GLfloat scale, bool rightToLeft)
+{
+    LayoutKey key = { text, scale, rightToLeft };
+    auto it = layouts.find(key);
+    if (it != layouts.end())
+    {
+        Layout& layout = it->second;
+        layout.lastUsedFrame = frame;
+        for (GLuint page = 0; page < pages.size(); ++page)
+        {
+            if (layout.pages & (1u << page))
             {
-                position.x = xStart;
-                position.y -= lineHeight * scale * 2.0f;
-                continue;
+                pages[page].lastUsedFrame = frame;
             }
+        }
+        return layout;
+    }
 
-            GLfloat xpos = position.x + ch.bearing.x * scale;
-            GLfloat ypos = position.y + static_cast<float>(lineHeight - ch.bearing.y) * scale;
+    std::vector<Vertex> vertices;
+    uint32_t pageMask = 0;
+    layOut(text, scale, rightToLeft, vertices, pageMask);
+    reserveLayoutSpace(vertices.size());
 
-            GLfloat w = ch.size.x * scale;
-            GLfloat h = ch.size.y * scale;
+    Layout layout = {
+        .first = static_cast<GLuint>(layoutVertices.size()),
+        .count = static_cast<GLuint>(vertices.size()),
+        .lastUsedFrame = frame,
+        .pages = pageMask
+    };
+    layoutVertices.insert(layoutVertices.end(), vertices.begin(), vertices.end());
 
-            GLfloat vertices[6][4] = {
-                { xpos, ypos + h, 0.0f, 1.0f },
-                { xpos + w, ypos, 1.0f, 0.0f },
-                { xpos, ypos, 0.0f, 0.0f },
+    glBindBuffer(GL_ARRAY_BUFFER, layoutBuffer);
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(layout.first * sizeof(Vertex)),
+                    static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)), vertices.data());
 
-                { xpos, ypos + h, 0.0f, 1.0f },
-                { xpos + w, ypos + h, 1.0f, 1.0f },
-                { xpos + w, ypos, 1.0f, 0.0f }
-            };
+    return layouts.emplace(std::move(key), layout).first->second;
+}
 
-            glBindTexture(GL_TEXTURE_2D, ch.textureID);
+void TextRenderer::layOut(const std::string& text, GLfloat scale, bool rightToLeft, std::vector<Vertex>& vertices,
+                          uint32_t& pageMask)
+{
+    std::u32string codePoints = toUtf32(text);
+    scale *= fontScale;
+    auto lineHeight = static_cast<float>(characters['H'].size.y);
+    glm::vec2 position(0.0f);
+    vertices.reserve(codePoints.size() * 6);
 
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+    auto add = [&](char32_t c)
+    {
+        const Character& ch = getCharacter(c);
+        if (ch.size.x > 0 && ch.size.y > 0)
+        {
+            pageMask |= 1u << ch.page;
+        }
+        addQuad(ch, position, lineHeight, scale, vertices);
+        return static_cast<float>(ch.advance >> 6) * scale;
+    };
 
-            glDrawArrays(GL_TRIANGLES, 0, 6);
+    if (rightToLeft)
+    {
+        auto newLineCount = std::count(codePoints.begin(), codePoints.end(), U'\n');
+        position.y += newLineCount * lineHeight * scale * 2.0f;
 
-            position.x -= (ch.advance >> 6) * scale;
+        for (auto c = codePoints.rbegin(); c != codePoints.rend(); ++c)
+        {
+            if (*c == U'\n')
+            {
+                position.x = 0.0f;
+                position.y -= lineHeight * scale * 2.0f;
+                continue;
+            }
+
+            position.x -= add(*c);
         }
     }
     else
     {
-        size_t size = text.size();
-        for (size_t i = 0; i < size; ++i)
+        for (char32_t c : codePoints)
         {
-            char c = text[i];
-            Character ch = characters[c];
-
-            if (c == '\n')
+            if (c == U'\n')
             {
-                position.x = xStart;
+                position.x = 0.0f;
                 position.y += lineHeight * scale * 2.0f;
                 continue;
             }
-            else if (c == '\t')
+            else if (c == U'\t')
             {
                 continue;
             }
-//            else if (c == '\t')
-//            {
-//                size_t next = (i + 3) & ~0x03;
-//                if (i % 4 == 0)
-//                {
-//                    next += 4;
-//                }
-//                size_t count = next - i;
-//                text.insert(i + 1, count, ' ');
-//                size += count;
-//                continue;
-//            }
-
-            GLfloat xpos = position.x + ch.bearing.x * scale;
-            GLfloat ypos = position.y + static_cast<float>(lineHeight - ch.bearing.y) * scale;
-
-            GLfloat w = ch.size.x * scale;
-            GLfloat h = ch.size.y * scale;
-
-            GLfloat vertices[6][4] = {
-                { xpos, ypos + h, 0.0f, 1.0f },
-                { xpos + w, ypos, 1.0f, 0.0f },
-                { xpos, ypos, 0.0f, 0.0f },
-
-                { xpos, ypos + h, 0.0f, 1.0f },
-                { xpos + w, ypos + h, 1.0f, 1.0f },
-                { xpos + w, ypos, 1.0f, 0.0f }
-            };
-
-            glBindTexture(GL_TEXTURE_2D, ch.textureID);
-
-            glBindBuffer(GL_ARRAY_BUFFER, vbo);
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            position.x += (ch.advance >> 6) * scale;
+
+            position.x += add(c);
         }
     }
+}
 
-    glBindVertexArray(0);
+void TextRenderer::addQuad(const Character& ch, glm::vec2 position, float lineHeight, GLfloat scale,
+                           std::vector<Vertex>& vertices) const
+{
+    if (ch.size.x == 0 || ch.size.y == 0)
+    {
+        return;
+    }
 
-    glDisable(GL_BLEND);
+    // The quad covers the whole distance field, which extends past the glyph's outline by the spread.
+    auto spread = static_cast<float>(SDF_SPREAD);
+    GLfloat xpos = position.x + (static_cast<float>(ch.bearing.x) - spread) * scale;
+    GLfloat ypos = position.y + (lineHeight - static_cast<float>(ch.bearing.y) - spread) * scale;
+
+    GLfloat w = (static_cast<float>(ch.size.x) + 2.0f * spread) * scale;
+    GLfloat h = (static_cast<float>(ch.size.y) + 2.0f * spread) * scale;
+    auto page = static_cast<GLfloat>(ch.page);
+
+    Vertex topLeft = { { xpos, ypos }, ch.uvMin, page };
+    Vertex topRight = { { xpos + w, ypos }, { ch.uvMax.x, ch.uvMin.y }, page };
+    Vertex bottomLeft = { { xpos, ypos + h }, { ch.uvMin.x, ch.uvMax.y }, page };
+    Vertex bottomRight = { { xpos + w, ypos + h }, ch.uvMax, page };
+
+    vertices.insert(vertices.end(), { bottomLeft, topRight, topLeft, bottomLeft, bottomRight, topRight });
+}
+
+void TextRenderer::reserveLayoutSpace(size_t count)
+{
+    if (layoutVertices.size() + count <= layoutCapacity)
+    {
+        return;
+    }
+
+    // Evict layouts not drawn this frame and move the rest to the front. Layouts queued this frame stay, so the draw
+    // commands already queued are rewritten with their new position.
+    std::vector<Vertex> compacted;
+    compacted.reserve(layoutVertices.size());
+    std::unordered_map<GLuint, GLuint> moved;
+    for (auto it = layouts.begin(); it != layouts.end();)
+    {
+        Layout& layout = it->second;
+        if (layout.lastUsedFrame < frame)
+        {
+            it = layouts.erase(it);
+            continue;
+        }
+
+        if (layout.count == 0)
+        {
+            layout.first = 0;
+            ++it;
+            continue;
+        }
+
+        moved[layout.first] = static_cast<GLuint>(compacted.size());
+        compacted.insert(compacted.end(), layoutVertices.begin() + layout.first,
+                         layoutVertices.begin() + layout.first + layout.count);
+        layout.first = moved[layout.first];
+        ++it;
+    }
+    for (auto& command : commands)
+    {
+        command.first = moved[command.first];
+    }
+    layoutVertices = std::move(compacted);
+
+    while (layoutVertices.size() + count > layoutCapacity)
+    {
+        layoutCapacity *= 2;
+    }
+    uploadLayouts();
+}
+
+void TextRenderer::uploadLayouts()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, layoutBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(layoutCapacity * sizeof(Vertex)), nullptr, GL_DYNAMIC_DRAW);
+    MemoryTracker::trackBuffer(layoutBuffer, MemoryCategory::Font, layoutCapacity * sizeof(Vertex));
+    if (!layoutVertices.empty())
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(layoutVertices.size() * sizeof(Vertex)),
+                        layoutVertices.data());
+    }
 }
@@ -2,39 +2,156 @@
 #define KUMIGAME_RENDERER_TEXT_RENDERER_HPP
 
 #include "shader.hpp"
+#include "skylinePacker.hpp"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 #include <glm/glm.hpp>
 #include <glad/glad.h>
-#include <map>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct Character
 {
-    GLuint textureID;
     glm::ivec2 size;
     glm::ivec2 bearing;
     FT_Pos advance;
+    // Corners of the glyph's distance field in the atlas, including the spread around the glyph.
+    glm::vec2 uvMin;
+    glm::vec2 uvMax;
+    GLuint page;
 };
 
-// TODO: Store glyphs in one texture and render in one draw call.
+/**
+ * @brief Draws UTF-8 text from a signed distance field glyph atlas.
+ *
+ * Glyphs are rasterized once at a fixed size and stored as distance fields, so text of any scale is drawn from the
+ * same atlas. ASCII is loaded up front into the first atlas page, which is never evicted; any other code point is
+ * rasterized the first time it is drawn into one of the remaining pages. When every page is full, the least recently
+ * drawn page is cleared and reused, so memory stays bounded by the page count whatever the font size or script.
+ *
+ * Laid out strings are kept in a GPU buffer, keyed by their text and scale, and only laid out again once they have
+ * been evicted. render() queues a draw of the cached layout with its own position and color; flush() draws all text
+ * queued since the last flush with one indirect multi-draw call.
+ */
 class TextRenderer
 {
 public:
     TextRenderer(GLuint width, GLuint height, std::shared_ptr<Shader>& shader, const std::string& fontPath, GLuint fontSize);
+    ~TextRenderer();
 
-    void render(std::string text, glm::vec2 position, GLfloat scale,
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    void render(const std::string& text, glm::vec2 position, GLfloat scale,
                 glm::vec4 color = glm::vec4(1.0f), bool rightToLeft = false);
+    // @brief Draws all text queued by render() since the last flush.
+    void flush();
 
 private:
+    struct Vertex
+    {
+        glm::vec2 position;
+        glm::vec2 texCoords;
+        GLfloat page;
+    };
+
+    struct Instance
+    {
+        glm::vec2 offset;
+        glm::vec4 color;
+    };
+
+    // Matches the layout glMultiDrawArraysIndirect() reads.
+    struct DrawCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    struct LayoutKey
+    {
+        std::string text;
+        GLfloat scale;
+        bool rightToLeft;
+
+        bool operator==(const LayoutKey& other) const;
+    };
+
+    struct LayoutKeyHash
+    {
+        size_t operator()(const LayoutKey& key) const;
+    };
+
+    struct Layout
+    {
+        GLuint first;
+        GLuint count;
+        unsigned long long lastUsedFrame;
+        // Bit i is set when the layout uses a glyph from atlas page i.
+        uint32_t pages;
+    };
+
+    struct AtlasPage
+    {
+        SkylinePacker packer;
+        std::vector<char32_t> glyphs;
+        unsigned long long lastUsedFrame;
+    };
+
+    static const int ATLAS_SIZE = 512;
+    static const int ATLAS_PAGES = 4;
+    // Empty texels around each glyph so linear filtering never picks up a neighbour.
+    static const int GLYPH_PADDING = 1;
+    // Pixel size glyphs are rasterized at, and how many texels the distance field extends beyond their outline.
+    static const int SDF_SIZE = 32;
+    static const int SDF_SPREAD = 4;
+    static const size_t INITIAL_LAYOUT_CAPACITY = 32768;
+
     GLuint vao = 0;
-    GLuint vbo = 0;
+    GLuint layoutBuffer = 0;
+    GLuint instanceBuffer = 0;
+    GLuint commandBuffer = 0;
+    GLuint atlas = 0;
     std::shared_ptr<Shader> shader;
-    std::map<GLchar, Character> characters;
+    FT_Library library = nullptr;
+    FT_Face face = nullptr;
+    // Scale from the rasterized size to the requested font size.
+    float fontScale = 1.0f;
+    std::array<Character, 128> characters{};
+    std::unordered_map<char32_t, Character> glyphs;
+    std::vector<AtlasPage> pages;
+
+    // CPU copy of the layout buffer, used to compact it when it runs out of space.
+    std::vector<Vertex> layoutVertices;
+    size_t layoutCapacity = 0;
+    std::unordered_map<LayoutKey, Layout, LayoutKeyHash> layouts;
+    unsigned long long frame = 0;
+
+    std::vector<Instance> instances;
+    std::vector<DrawCommand> commands;
+    size_t instanceCapacity = 0;
+    size_t commandCapacity = 0;
 
     void initRenderDescriptor(GLuint width, GLuint height, std::shared_ptr<Shader> &textShader);
     void loadFont(const std::string& fontPath, GLuint fontSize);
+    bool loadGlyph(char32_t codePoint, Character& character);
+    const Character& getCharacter(char32_t codePoint);
+    std::optional<glm::ivec2> allocateGlyph(glm::ivec2 size, GLuint& page);
+    void evictPage(GLuint page);
+    const Layout& getLayout(const std::string& text, GLfloat scale, bool rightToLeft);
+    void layOut(const std::string& text, GLfloat scale, bool rightToLeft, std::vector<Vertex>& vertices,
+                uint32_t& pageMask);
+    void addQuad(const Character& ch, glm::vec2 position, float lineHeight, GLfloat scale,
+                 std::vector<Vertex>& vertices) const;
+    void reserveLayoutSpace(size_t count);
+    void uploadLayouts();
 };
 
 #endif //KUMIGAME_RENDERER_TEXT_RENDERER_HPP
@@ -1,4 +1,5 @@
 #include "../debug/log.hpp"
+#include "../debug/memoryTracker.hpp"
 #include <glad/glad.h>
 #include <stb_image.h>
 #include <string>
@@ -31,6 +32,8 @@ uint32_t textureFromFile(const std::string& path, const std::string& directory)
         glBindTexture(GL_TEXTURE_2D, textureID);
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
+        MemoryTracker::trackTexture(textureID, MemoryCategory::Texture,
+                                    MemoryTracker::textureSize(format, width, height, 1, 1, true));
 
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
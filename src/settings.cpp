@@ -5,6 +5,31 @@
 #include <limits>
 #include <string>
 
+// Returns the table at the given keys, or an empty table if it does not exist.
+template <typename... Keys>
+toml::value findTable(const toml::value& root, const Keys&... keys)
+{
+    try
+    {
+        return toml::find(root, keys...);
+    }
+    catch (const std::out_of_range&)
+    {
+        return toml::table{};
+    }
+}
+
+// Returns the child table with the given key, creating it if it does not exist.
+toml::value& findOrCreateTable(toml::value& parent, const std::string& key)
+{
+    auto& table = parent.as_table();
+    if (table.count(key) == 0)
+    {
+        table[key] = toml::table{};
+    }
+    return table[key];
+}
+
 // TODO: Add more checks for valid settings.
 void readSettings(Settings &settings, const char *filepath)
 {
@@ -21,6 +46,123 @@ void readSettings(Settings &settings, const char *filepath)
         settings.fov = toml::find_or<float>(graphicsDisplay, "fov", static_cast<float>(settings.fov));
         settings.superSampling = toml::find_or<float>(graphicsDisplay, "superSampling", static_cast<float>(settings.superSampling));
 
+        auto antiAliasing = toml::find_or<std::string>(graphicsDisplay, "antiAliasing", antiAliasingToString(settings.antiAliasing));
+        if (auto mode = antiAliasingFromString(antiAliasing))
+        {
+            settings.antiAliasing = mode.value();
+        }
+        else
+        {
+            LOG_ERROR("Unknown anti-aliasing mode \"{}\". Check [graphics.display] in {}. Using {}.",
+                      antiAliasing, filepath, antiAliasingToString(settings.antiAliasing));
+        }
+
+        settings.pointLights = toml::find_or<int>(graphicsDisplay, "pointLights", settings.pointLights);
+        if (settings.pointLights < 1 || settings.pointLights > 4)
+        {
+            LOG_ERROR("Point light count {} out of range 1 to 4. Check [graphics.display] in {}. Using 4.",
+                      settings.pointLights, filepath);
+            settings.pointLights = 4;
+        }
+
+        // [graphics.dynamicResolution]
+        auto graphicsDynamicResolution = findTable(settings.file, "graphics", "dynamicResolution");
+        settings.dynamicResolution = toml::find_or<bool>(graphicsDynamicResolution, "enabled", settings.dynamicResolution);
+        settings.targetFrameTime = toml::find_or<float>(graphicsDynamicResolution, "targetFrameTime", static_cast<float>(settings.targetFrameTime));
+        settings.minRenderScale = toml::find_or<float>(graphicsDynamicResolution, "minScale", static_cast<float>(settings.minRenderScale));
+        settings.maxRenderScale = toml::find_or<float>(graphicsDynamicResolution, "maxScale", static_cast<float>(settings.maxRenderScale));
+
+        if (settings.minRenderScale <= 0.0f || settings.minRenderScale > settings.maxRenderScale)
+        {
+            LOG_ERROR("Dynamic resolution scale range {} to {} is invalid. Check [graphics.dynamicResolution] in {}. Using 0.5 to 1.0.",
+                      settings.minRenderScale, settings.maxRenderScale, filepath);
+            settings.minRenderScale = 0.5f;
+            settings.maxRenderScale = 1.0f;
+        }
+
+        // [graphics.temporal]
+        auto graphicsTemporal = findTable(settings.file, "graphics", "temporal");
+        settings.temporalUpsampling = toml::find_or<bool>(graphicsTemporal, "enabled", settings.temporalUpsampling);
+        settings.temporalScale = toml::find_or<float>(graphicsTemporal, "scale", static_cast<float>(settings.temporalScale));
+
+        if (settings.temporalScale <= 0.0f || settings.temporalScale > 1.0f)
+        {
+            LOG_ERROR("Temporal upsampling scale {} out of range 0 to 1. Check [graphics.temporal] in {}. Using 0.6.",
+                      settings.temporalScale, filepath);
+            settings.temporalScale = 0.6f;
+        }
+
+        // [graphics.calibration]
+        auto graphicsCalibration = findTable(settings.file, "graphics", "calibration");
+        settings.calibrated = toml::find_or<bool>(graphicsCalibration, "calibrated", settings.calibrated);
+        settings.calibrationFrameTime = toml::find_or<float>(graphicsCalibration, "targetFrameTime", static_cast<float>(settings.calibrationFrameTime));
+
+        if (settings.calibrationFrameTime <= 0.0f)
+        {
+            LOG_ERROR("Calibration target frame time {} ms is not positive. Check [graphics.calibration] in {}. Using 12.",
+                      settings.calibrationFrameTime, filepath);
+            settings.calibrationFrameTime = 12.0f;
+        }
+
+        // [graphics.memory]
+        auto graphicsMemory = findTable(settings.file, "graphics", "memory");
+        settings.vramBudget = toml::find_or<int>(graphicsMemory, "vramBudget", settings.vramBudget);
+
+        if (settings.vramBudget < 0)
+        {
+            LOG_ERROR("VRAM budget {} is negative. Check [graphics.memory] in {}. Using 2048.", settings.vramBudget, filepath);
+            settings.vramBudget = 2048;
+        }
+
+        // [simulation]
+        auto simulation = findTable(settings.file, "simulation");
+        settings.tickRate = toml::find_or<int>(simulation, "tickRate", settings.tickRate);
+        settings.maxTicksPerFrame = toml::find_or<int>(simulation, "maxTicksPerFrame", settings.maxTicksPerFrame);
+
+        if (settings.tickRate < 1 || settings.tickRate > 1000)
+        {
+            LOG_ERROR("Tick rate {} Hz out of range 1 to 1000. Check [simulation] in {}. Using 60.",
+                      settings.tickRate, filepath);
+            settings.tickRate = 60;
+        }
+        if (settings.maxTicksPerFrame < 1)
+        {
+            LOG_ERROR("Maximum ticks per frame {} is not positive. Check [simulation] in {}. Using 5.",
+                      settings.maxTicksPerFrame, filepath);
+            settings.maxTicksPerFrame = 5;
+        }
+
+        // [debug.flightRecorder]
+        auto debugFlightRecorder = findTable(settings.file, "debug", "flightRecorder");
+        settings.flightRecorder = toml::find_or<bool>(debugFlightRecorder, "enabled", settings.flightRecorder);
+        settings.flightRecorderSeconds = toml::find_or<float>(debugFlightRecorder, "seconds", static_cast<float>(settings.flightRecorderSeconds));
+        settings.hitchFactor = toml::find_or<float>(debugFlightRecorder, "hitchFactor", static_cast<float>(settings.hitchFactor));
+
+        if (settings.flightRecorderSeconds <= 0.0f)
+        {
+            LOG_ERROR("Flight recorder length {} s is not positive. Check [debug.flightRecorder] in {}. Using 10.",
+                      settings.flightRecorderSeconds, filepath);
+            settings.flightRecorderSeconds = 10.0f;
+        }
+        if (settings.hitchFactor <= 1.0f)
+        {
+            LOG_ERROR("Hitch factor {} must be above 1. Check [debug.flightRecorder] in {}. Using 3.",
+                      settings.hitchFactor, filepath);
+            settings.hitchFactor = 3.0f;
+        }
+
+        // [debug.metrics]
+        auto debugMetrics = findTable(settings.file, "debug", "metrics");
+        settings.metrics = toml::find_or<bool>(debugMetrics, "enabled", settings.metrics);
+        settings.metricsPort = toml::find_or<int>(debugMetrics, "port", settings.metricsPort);
+
+        if (settings.metricsPort < 1 || settings.metricsPort > 65535)
+        {
+            LOG_ERROR("Metrics port {} out of range 1 to 65535. Check [debug.metrics] in {}. Using 9464.",
+                      settings.metricsPort, filepath);
+            settings.metricsPort = 9464;
+        }
+
         // [log.level]
         auto logLevel = toml::find(settings.file, "log", "level");
         int consoleLevel = toml::find_or<int>(logLevel, "console", settings.consoleLogLevel);
@@ -65,6 +207,46 @@ void saveSettings(Settings &settings, const char *filepath)
         toml::find(graphicsDisplay, "fullscreen") = settings.fullscreen;
         toml::find(graphicsDisplay, "vSync") = settings.vSync;
         toml::find(graphicsDisplay, "fov") = settings.fov;
+        toml::find(graphicsDisplay, "superSampling") = settings.superSampling;
+        graphicsDisplay.as_table()["antiAliasing"] = antiAliasingToString(settings.antiAliasing);
+        graphicsDisplay.as_table()["pointLights"] = settings.pointLights;
+
+        // [graphics.dynamicResolution]
+        toml::value& graphicsDynamicResolution = findOrCreateTable(toml::find(settings.file, "graphics"), "dynamicResolution");
+        graphicsDynamicResolution.as_table()["enabled"] = settings.dynamicResolution;
+        graphicsDynamicResolution.as_table()["targetFrameTime"] = settings.targetFrameTime;
+        graphicsDynamicResolution.as_table()["minScale"] = settings.minRenderScale;
+        graphicsDynamicResolution.as_table()["maxScale"] = settings.maxRenderScale;
+
+        // [graphics.temporal]
+        toml::value& graphicsTemporal = findOrCreateTable(toml::find(settings.file, "graphics"), "temporal");
+        graphicsTemporal.as_table()["enabled"] = settings.temporalUpsampling;
+        graphicsTemporal.as_table()["scale"] = settings.temporalScale;
+
+        // [graphics.calibration]
+        toml::value& graphicsCalibration = findOrCreateTable(toml::find(settings.file, "graphics"), "calibration");
+        graphicsCalibration.as_table()["calibrated"] = settings.calibrated;
+        graphicsCalibration.as_table()["targetFrameTime"] = settings.calibrationFrameTime;
+
+        // [graphics.memory]
+        toml::value& graphicsMemory = findOrCreateTable(toml::find(settings.file, "graphics"), "memory");
+        graphicsMemory.as_table()["vramBudget"] = settings.vramBudget;
+
+        // [simulation]
+        toml::value& simulation = findOrCreateTable(settings.file, "simulation");
+        simulation.as_table()["tickRate"] = settings.tickRate;
+        simulation.as_table()["maxTicksPerFrame"] = settings.maxTicksPerFrame;
+
+        // [debug.flightRecorder]
+        toml::value& debugFlightRecorder = findOrCreateTable(findOrCreateTable(settings.file, "debug"), "flightRecorder");
+        debugFlightRecorder.as_table()["enabled"] = settings.flightRecorder;
+        debugFlightRecorder.as_table()["seconds"] = settings.flightRecorderSeconds;
+        debugFlightRecorder.as_table()["hitchFactor"] = settings.hitchFactor;
+
+        // [debug.metrics]
+        toml::value& debugMetrics = findOrCreateTable(findOrCreateTable(settings.file, "debug"), "metrics");
+        debugMetrics.as_table()["enabled"] = settings.metrics;
+        debugMetrics.as_table()["port"] = settings.metricsPort;
 
         // [log.level]
         toml::value& logLevel = toml::find(settings.file, "log", "level");
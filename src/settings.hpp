@@ -1,6 +1,7 @@
 #ifndef KUMIGAME_SETTINGS_HPP
 #define KUMIGAME_SETTINGS_HPP
 
+#include "renderer/antiAliasing.hpp"
 #include <spdlog/spdlog.h>
 #include <toml11/toml.hpp>
 
@@ -15,6 +16,38 @@ struct Settings
     bool vSync = false;
     float fov = 80.0f;
     float superSampling = 1.0f;
+    AntiAliasing antiAliasing = AntiAliasing::Off;
+    int pointLights = 4;
+
+    // Dynamic resolution
+    bool dynamicResolution = false;
+    float targetFrameTime = 14.0f;
+    float minRenderScale = 0.5f;
+    float maxRenderScale = 1.0f;
+
+    // Temporal upsampling
+    bool temporalUpsampling = false;
+    float temporalScale = 0.6f;
+
+    // Calibration
+    bool calibrated = false;
+    float calibrationFrameTime = 12.0f;
+
+    // Memory
+    int vramBudget = 2048;
+
+    // Simulation
+    int tickRate = 60;
+    int maxTicksPerFrame = 5;
+
+    // Flight recorder
+    bool flightRecorder = true;
+    float flightRecorderSeconds = 10.0f;
+    float hitchFactor = 3.0f;
+
+    // Metrics
+    bool metrics = false;
+    int metricsPort = 9464;
 
     // Log
     spdlog::level::level_enum consoleLogLevel = spdlog::level::critical;
@@ -0,0 +1,20 @@
+#ifndef KUMIGAME_UTIL_CLOCK_HPP
+#define KUMIGAME_UTIL_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+// nanoseconds since an arbitrary point on a monotonic clock
+static inline int64_t nowNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// seconds since an arbitrary point on a monotonic clock
+static inline double nowSeconds()
+{
+    return static_cast<double>(nowNanoseconds()) / 1e9;
+}
+
+#endif //KUMIGAME_UTIL_CLOCK_HPP
@@ -0,0 +1,49 @@
+#ifndef KUMIGAME_UTIL_FRUSTUM_HPP
+#define KUMIGAME_UTIL_FRUSTUM_HPP
+
+#include <glm/glm.hpp>
+#include <array>
+
+// planes of a view frustum as (normal, distance) with normals pointing inwards, in the space the matrix maps from
+struct Frustum
+{
+    // left, right, bottom, top, near, far
+    std::array<glm::vec4, 6> planes;
+};
+
+// extract the frustum planes of a view-projection matrix (Gribb and Hartmann)
+static inline Frustum extractFrustum(const glm::mat4& viewProjection)
+{
+    glm::mat4 m = glm::transpose(viewProjection);
+    Frustum frustum;
+    frustum.planes[0] = m[3] + m[0];
+    frustum.planes[1] = m[3] - m[0];
+    frustum.planes[2] = m[3] + m[1];
+    frustum.planes[3] = m[3] - m[1];
+    frustum.planes[4] = m[3] + m[2];
+    frustum.planes[5] = m[3] - m[2];
+    for (glm::vec4& plane : frustum.planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+// whether an axis-aligned box is at least partly inside the frustum; conservative near the frustum's edges
+static inline bool intersects(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max)
+{
+    for (const glm::vec4& plane : frustum.planes)
+    {
+        // The corner furthest along the plane's normal.
+        glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x,
+                         plane.y >= 0.0f ? max.y : min.y,
+                         plane.z >= 0.0f ? max.z : min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif //KUMIGAME_UTIL_FRUSTUM_HPP
@@ -0,0 +1,89 @@
+#ifndef KUMIGAME_UTIL_MPSC_QUEUE_HPP
+#define KUMIGAME_UTIL_MPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded queue for any number of producer threads and one consumer thread, without locks (after Dmitry Vyukov's
+// bounded MPMC queue). Every cell carries a sequence number telling whether it is free for the producer at that
+// position or filled for the consumer, so a push is one compare-and-swap and neither side ever waits for the other.
+template<typename T, size_t CAPACITY>
+class MpscQueue
+{
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0, "The capacity must be a power of two.");
+
+public:
+    MpscQueue()
+    {
+        for (size_t i = 0; i < CAPACITY; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // any thread: returns false if the queue is full
+    bool tryPush(const T& value)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &cells[position & (CAPACITY - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = value;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only: returns false if the queue is empty
+    bool tryPop(T& value)
+    {
+        Cell& cell = cells[head & (CAPACITY - 1)];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(head + 1) < 0)
+        {
+            return false;
+        }
+
+        value = cell.value;
+        cell.sequence.store(head + CAPACITY, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::array<Cell, CAPACITY> cells;
+    alignas(64) std::atomic<size_t> tail = 0;
+    alignas(64) size_t head = 0;
+};
+
+#endif //KUMIGAME_UTIL_MPSC_QUEUE_HPP
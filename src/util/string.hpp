@@ -1,6 +1,9 @@
 #ifndef KUMIGAME_UTIL_STRING_HPP
 #define KUMIGAME_UTIL_STRING_HPP
 
+#include <algorithm>
+#include <cctype>
+#include <iterator>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -56,4 +59,67 @@ static inline std::vector<std::string> split(const std::string& s)
     return std::vector<std::string>(begin, end);
 }
 
+// decode UTF-8 into code points, replacing malformed sequences with U+FFFD
+static inline std::u32string toUtf32(const std::string& s)
+{
+    std::u32string result;
+    result.reserve(s.size());
+    for (size_t i = 0; i < s.size();)
+    {
+        auto lead = static_cast<unsigned char>(s[i]);
+        size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > s.size())
+        {
+            result.push_back(U'\uFFFD');
+            i++;
+            continue;
+        }
+
+        char32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+        bool valid = true;
+        for (size_t j = 1; j < length; ++j)
+        {
+            auto continuation = static_cast<unsigned char>(s[i + j]);
+            if ((continuation >> 6) != 0x02)
+            {
+                valid = false;
+                break;
+            }
+            codePoint = (codePoint << 6) | (continuation & 0x3F);
+        }
+
+        result.push_back(valid ? codePoint : U'\uFFFD');
+        i += valid ? length : 1;
+    }
+    return result;
+}
+
+// escape quotes, backslashes and control characters for a JSON string
+static inline std::string escapeJson(const std::string& s)
+{
+    const char* hexDigits = "0123456789abcdef";
+    std::string escaped;
+    escaped.reserve(s.size());
+    for (char c : s)
+    {
+        auto u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (u < 0x20)
+        {
+            escaped += "\\u00";
+            escaped += hexDigits[u >> 4];
+            escaped += hexDigits[u & 0x0F];
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
 #endif //KUMIGAME_UTIL_STRING_HPP
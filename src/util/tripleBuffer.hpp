@@ -0,0 +1,48 @@
+#ifndef KUMIGAME_UTIL_TRIPLE_BUFFER_HPP
+#define KUMIGAME_UTIL_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locking. The writer fills getWriteBuffer()
+// and publishes it; the reader always sees the most recently published value, and neither ever waits for the other.
+template<typename T>
+class TripleBuffer
+{
+public:
+    // writer only
+    T& getWriteBuffer()
+    {
+        return buffers[writeIndex];
+    }
+
+    // writer only: swaps the filled buffer with the one in the middle
+    void publish()
+    {
+        writeIndex = state.exchange(writeIndex | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // reader only: returns the latest published value, or the previous one if nothing new was published
+    const T& read()
+    {
+        if (state.load(std::memory_order_relaxed) & DIRTY)
+        {
+            readIndex = state.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return buffers[readIndex];
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 3;
+    // Set when the middle buffer holds a value the reader has not taken yet.
+    static constexpr uint8_t DIRTY = 4;
+
+    std::array<T, 3> buffers{};
+    // Index of the middle buffer, plus DIRTY.
+    std::atomic<uint8_t> state = 1;
+    uint8_t writeIndex = 0;
+    uint8_t readIndex = 2;
+};
+
+#endif //KUMIGAME_UTIL_TRIPLE_BUFFER_HPP